@@ -0,0 +1,337 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_BINARY_SEARCH_TREE_H
+#define APFN_DATA_STRUCTURES_BINARY_SEARCH_TREE_H
+
+#include <cstddef>      // size_t, std::ptrdiff_t
+#include <iterator>     // std::forward_iterator_tag
+#include <utility>      // std::forward, std::declval, std::pair
+#include <type_traits>  // std::true_type, std::false_type, std::remove_reference
+
+#include "node_pool.h"
+
+namespace vvalgo {
+
+    /*
+     * The BST functions work on any node with value, left, right and parent members, reached through any
+     * NodePtr that behaves like a pointer: raw pointers, or 32-bit CompactPtrs (see compact_tree.h). This is
+     * how they create and free nodes for a given kind of pointer. Raw pointers use new and delete.
+     */
+    template <typename NodePtr>
+    struct NodePtrTraits;
+
+    template <typename Node>
+    struct NodePtrTraits<Node *> {
+        template <typename... Args>
+        static Node *create(Args&&... args) {return new Node(std::forward<Args>(args)...);}
+
+        static void destroy(Node *node) {
+            node->left = node->right = node->parent = nullptr;// nil out child pointers because delete cascades to these via the destructor.
+            delete node;
+        }
+    };
+
+    namespace BST { // Encapsulating BST related functions inside a separate namespace.
+        /*
+         * An augmented node keeps something about its whole subtree, like its size, and has a
+         * recomputeAugmentation() member that works it out again from the node and its children. The functions
+         * here and in RB call it, bottom up, on every node whose subtree they change. For other nodes the calls
+         * compile to nothing.
+         */
+        template <typename NodePtr>
+        auto isAugmented(NodePtr node) -> decltype(node->recomputeAugmentation(), std::true_type());
+        std::false_type isAugmented(...);
+
+        template <typename NodePtr>
+        void recomputeAugmentation(NodePtr node, std::true_type) {node->recomputeAugmentation();}
+
+        template <typename NodePtr>
+        void recomputeAugmentation(NodePtr, std::false_type) {}
+
+        template <typename NodePtr>
+        void recomputeAugmentation(NodePtr node) {
+            recomputeAugmentation(node, decltype(isAugmented(std::declval<NodePtr>()))());
+        }
+
+        // Recomputes node and all its ancestors, after a change below node.
+        template <typename NodePtr>
+        void recomputeAugmentationUpward(NodePtr node) {
+            if (!decltype(isAugmented(std::declval<NodePtr>()))::value) {
+                return;
+            }
+            for (; node; node = node->parent) {
+                recomputeAugmentation(node);
+            }
+        }
+
+        // find() will perform binary search since we are dealing with a binary search tree
+        template <typename NodePtr, typename ValueType>
+        NodePtr find(NodePtr root, ValueType val) {
+            while (root && !(val == root->value)) {
+                root = (val < root->value) ? root->left : root->right;
+            }
+            return root;
+        }
+
+        // insert() will perform a binary search to find the entry or insert the node at the right location
+        template <typename NodePtr, typename ValueType>
+        NodePtr insert(NodePtr *root, ValueType val, NodePtr parentOfRoot = NodePtr()) {
+            if (!root) {
+                return NodePtr();
+            }
+            NodePtr parent = parentOfRoot;
+            while (*root) {
+                parent = *root;
+                root = (val < parent->value) ? &parent->left : &parent->right;
+            }
+            *root = NodePtrTraits<NodePtr>::create(val, nullptr, nullptr, parent);
+            recomputeAugmentationUpward(*root);
+            return *root;
+        }
+
+        // Same as above, but the new node comes from pool.
+        template <typename BSTType, typename ValueType, size_t SlabNodes>
+        BSTType *insert(BSTType **root, ValueType val, NodePool<BSTType, SlabNodes> &pool) {
+            if (!root) {
+                return nullptr;
+            }
+            BSTType *parent = nullptr;
+            while (*root) {
+                parent = *root;
+                root = (val < parent->value) ? &parent->left : &parent->right;
+            }
+            *root = pool.create(val, nullptr, nullptr, parent);
+            recomputeAugmentationUpward(*root);
+            return *root;
+        }
+
+        // returns the minimum node in the BST
+        template <typename NodePtr>
+        NodePtr min(NodePtr root) {
+            while (root && root->left) {
+                root = root->left;
+            }
+            return root;
+        }
+
+        // returns the maximum node in the BST
+        template <typename NodePtr>
+        NodePtr max(NodePtr root) {
+            while (root && root->right) {
+                root = root->right;
+            }
+            return root;
+        }
+
+        // The next node in sorted order, or null after the last one. Climbs the parent links when there is
+        // nothing to the right, so walking a whole tree this way follows each link twice: O(1) per step on average.
+        template <typename NodePtr>
+        NodePtr successor(NodePtr node) {
+            if (node->right) {
+                return min(node->right);
+            }
+            NodePtr parent = node->parent;
+            while (parent && (node == parent->right)) {
+                node = parent;
+                parent = node->parent;
+            }
+            return parent;
+        }
+
+        // The previous node in sorted order, or null before the first one.
+        template <typename NodePtr>
+        NodePtr predecessor(NodePtr node) {
+            if (node->left) {
+                return max(node->left);
+            }
+            NodePtr parent = node->parent;
+            while (parent && (node == parent->left)) {
+                node = parent;
+                parent = node->parent;
+            }
+            return parent;
+        }
+
+        // The first node in sorted order whose value is not less than val, or null if there is none.
+        template <typename NodePtr, typename ValueType>
+        NodePtr lowerBound(NodePtr root, const ValueType &val) {
+            NodePtr bound = NodePtr();
+            while (root) {
+                if (root->value < val) {
+                    root = root->right;
+                } else {
+                    bound = root;
+                    root = root->left;
+                }
+            }
+            return bound;
+        }
+
+        // The first node in sorted order whose value is greater than val, or null if there is none.
+        template <typename NodePtr, typename ValueType>
+        NodePtr upperBound(NodePtr root, const ValueType &val) {
+            NodePtr bound = NodePtr();
+            while (root) {
+                if (val < root->value) {
+                    bound = root;
+                    root = root->left;
+                } else {
+                    root = root->right;
+                }
+            }
+            return bound;
+        }
+
+        /*
+         * Walks the nodes from first up to but not including last, in sorted order, through successor(). A null
+         * last means the end of the tree. Visiting k nodes this way costs O(log n + k) in a balanced tree.
+         */
+        template <typename NodePtr>
+        class RangeIterator {
+        public:
+            typedef typename std::remove_reference<decltype(*std::declval<NodePtr>())>::type Node;
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Node value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef Node *pointer;
+            typedef Node &reference;
+
+            explicit RangeIterator(NodePtr n = NodePtr()) : node(n) {}
+
+            reference operator*() const {return *node;}
+            NodePtr operator->() const {return node;}
+            NodePtr get() const {return node;}
+
+            RangeIterator &operator++() {
+                node = successor(node);
+                return *this;
+            }
+
+            RangeIterator operator++(int) {
+                RangeIterator previous(*this);
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(const RangeIterator &other) const {return node == other.node;}
+            bool operator!=(const RangeIterator &other) const {return node != other.node;}
+
+        private:
+            NodePtr node;
+        }; // CS : RangeIterator
+
+        // A begin/end pair of RangeIterators, for range-based for loops.
+        template <typename NodePtr>
+        class Range {
+        public:
+            Range(NodePtr first, NodePtr last) : from(first), to(last) {}
+            RangeIterator<NodePtr> begin() const {return RangeIterator<NodePtr>(from);}
+            RangeIterator<NodePtr> end() const {return RangeIterator<NodePtr>(to);}
+            bool isEmpty() const {return from == to;}
+        private:
+            NodePtr from;
+            NodePtr to;
+        }; // CS : Range
+
+        // The nodes whose value equals val: [lowerBound(val), upperBound(val)).
+        template <typename NodePtr, typename ValueType>
+        Range<NodePtr> equalRange(NodePtr root, const ValueType &val) {
+            return Range<NodePtr>(lowerBound(root, val), upperBound(root, val));
+        }
+
+        // The nodes with low <= value < high, in sorted order.
+        template <typename NodePtr, typename ValueType>
+        Range<NodePtr> range(NodePtr root, const ValueType &low, const ValueType &high) {
+            if (!(low < high)) {
+                return Range<NodePtr>(NodePtr(), NodePtr());
+            }
+            return Range<NodePtr>(lowerBound(root, low), lowerBound(root, high));
+        }
+
+        // Every node, in sorted order.
+        template <typename NodePtr>
+        Range<NodePtr> all(NodePtr root) {
+            return Range<NodePtr>(min(root), NodePtr());
+        }
+
+        // Removes a node with the given value, if it exists, and hands it to dispose(), which has to free it.
+        template <typename NodePtr, typename ValueType, typename Dispose>
+        void removeWith(NodePtr *root, ValueType val, Dispose dispose) {
+            while (root && *root) {
+                NodePtr node = *root;
+                if (node->value == val) { // Found the target node.
+                    NodePtr parent = node->parent;
+                    if (!node->left && !node->right) {      // Target is a leaf node.
+                        *root = nullptr;
+                        dispose(node);
+                        recomputeAugmentationUpward(parent);
+                        return;
+                    }
+                    if (node->left && node->right) {        // Target has two children.
+                        NodePtr successor = min(node->right);
+                        node->value = successor->value;
+                        val = successor->value;             // Now remove the successor from the right subtree.
+                        root = &(node->right);
+                        continue;
+                    }
+                    NodePtr loneChild = (node->left) ? node->left : node->right; // Target node has only one child.
+                    *root = loneChild;
+                    loneChild->parent = parent; // Update the parent pointer of the lone child.
+                    dispose(node);
+                    recomputeAugmentationUpward(parent);
+                    return;
+                }
+                root = (val < node->value) ? &(node->left) : &(node->right); // Search in the left or right subtree.
+            }
+        }
+
+        // Removes a node with the given value, if it exists.
+        template <typename NodePtr, typename ValueType>
+        void remove(NodePtr *root, ValueType val) {
+            removeWith(root, val, [](NodePtr node) {NodePtrTraits<NodePtr>::destroy(node);});
+        }
+
+        // Same as above, for trees whose nodes come from pool.
+        template <typename BSTType, typename ValueType, size_t SlabNodes>
+        void remove(BSTType **root, ValueType val, NodePool<BSTType, SlabNodes> &pool) {
+            removeWith(root, val, [&pool](BSTType *node) {
+                node->parent = nullptr;
+                pool.destroy(node);
+            });
+        }
+
+        // Test ancestory
+        template <typename NodePtr>
+        size_t depth(NodePtr node) {
+            size_t d = 0;   // 0 means the node does not exist in the tree. It also prevents us from assigning this
+                            // depth to the root node. I could circumvent this by returning -1 for !node, while
+                            // returning 0 for !node->parent. But using a signed type for the return value, and
+                            // overloading the meaning of the return value doesnt seem like the right solution.
+            for (; node; node = node->parent) {
+                ++d;
+            }
+            return d;
+        }
+
+    } // NS : BST
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_BINARY_SEARCH_TREE_H
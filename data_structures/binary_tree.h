@@ -0,0 +1,290 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_BINARY_TREE_H
+#define APFN_DATA_STRUCTURES_BINARY_TREE_H
+
+#include <cstddef>        // size_t
+#include <vector>         // Batch lookups.
+#include <unordered_map>  // Value -> node index.
+#include <utility>        // std::make_pair
+
+#include "stack.h"
+#include "tree_traversal.h"
+
+namespace vvalgo {
+
+template <typename T>
+class BinaryTreeIndex;
+
+template <typename T>
+class BinaryTree {
+public:
+T value;
+BinaryTree * lChild; // TODO: convert to unique_ptr
+BinaryTree * rChild; // TODO: convert to unique_ptr
+
+// It is important to always allocate BinaryTree objects on the heap because we are calling delete 
+// in the destructor for the children. Except for the root, every node in the BinsryTree needs to be
+// allocated on the heap for this to work correctly. The ideal way would be to not use this exception and 
+// just allocate the root on the heap as well.
+BinaryTree(T val, BinaryTree * l=nullptr, BinaryTree *r = nullptr) : value(val), lChild(l), rChild(r) {}
+
+~BinaryTree() {
+	deleteSubtree(lChild);
+	deleteSubtree(rChild);
+}
+
+void replaceLeftChild(BinaryTree *newLChild) {
+	delete lChild;
+	lChild = newLChild;
+}
+
+void replaceRightChild(BinaryTree *newRChild) {
+	delete rChild;
+	rChild = newRChild;
+}
+
+// Same as above, and index forgets the nodes that go and learns the ones that come in.
+void replaceLeftChild(BinaryTree *newLChild, BinaryTreeIndex<T> &index) {
+	index.remove(lChild);
+	index.add(newLChild, this);
+	replaceLeftChild(newLChild);
+}
+
+void replaceRightChild(BinaryTree *newRChild, BinaryTreeIndex<T> &index) {
+	index.remove(rChild);
+	index.add(newRChild, this);
+	replaceRightChild(newRChild);
+}
+
+// I'm leaving the traversal methods outside of this class because they are not tightly
+// coupled with this implementation. They only require the object to have value, *lChild and *rchild
+// public members, which the TreeLinks specialization below points them at.
+// By keeping the traversal and related methods outside, I am enabling them to work
+// on BinaryTree as well as BinarySearchTree (and potentially also on SinglyLinkedList in which I
+// could set lChild always to nullptr).
+}; // CS : BinaryTree
+
+/*
+ * An optional value -> node hash index over a BinaryTree, for trees that are looked up far more often than they
+ * change: find() and findParent() are then a hash lookup each instead of a traversal. Build it from the root, and
+ * change the tree through the replaceLeftChild()/replaceRightChild() overloads that take it (or tell it with add()
+ * and remove()). Setting lChild, rChild or value by hand leaves it stale. If a value is in the tree more than once,
+ * find() returns one of its nodes, which need not be the first in in-order like findNodeWithValue()'s.
+ */
+template <typename T>
+class BinaryTreeIndex {
+public:
+	explicit BinaryTreeIndex(BinaryTree<T> *root = nullptr) {indexSubtree(root, nullptr, false);}
+
+	BinaryTree<T> *find(const T &value) const {
+		auto it = entries.find(value);
+		return (it == entries.end()) ? nullptr : it->second.node;
+	}
+
+	// Same contract as findParentOfNodeWithValue().
+	BinaryTree<T> *findParent(const T &value, bool &foundValueInRoot) const {
+		auto it = entries.find(value);
+		foundValueInRoot = (it != entries.end()) && !it->second.parent;
+		return (it == entries.end()) ? nullptr : it->second.parent;
+	}
+
+	size_t size() const {return entries.size();}
+
+	// Indexes every node of subtree, which hangs from parent (null if it is the root). A node the index already
+	// has, as when a subtree moves within the tree, keeps its one entry with the new parent.
+	void add(BinaryTree<T> *subtree, BinaryTree<T> *parent) {indexSubtree(subtree, parent, true);}
+
+	// Forgets every node of subtree.
+	void remove(BinaryTree<T> *subtree) {
+		Stack<BinaryTree<T> *, 64> pending;
+		if (subtree) {
+			pending.push(subtree);
+		}
+		BinaryTree<T> *node;
+		while (pending.pop(node)) {
+			auto range = entries.equal_range(node->value);
+			for (auto it = range.first; it != range.second; ++it) {
+				if (it->second.node == node) {
+					entries.erase(it);
+					break;
+				}
+			}
+			if (node->lChild) {
+				pending.push(node->lChild);
+			}
+			if (node->rChild) {
+				pending.push(node->rChild);
+			}
+		}
+	}
+
+private:
+	struct Entry {
+		BinaryTree<T> *node;
+		BinaryTree<T> *parent;
+	};
+
+	// Adds the nodes of subtree. If some may already be indexed (existing; never while building), their entries
+	// are looked for first and get the new parent.
+	void indexSubtree(BinaryTree<T> *subtree, BinaryTree<T> *parent, bool existing) {
+		Stack<Entry, 64> pending;
+		if (subtree) {
+			pending.push(Entry{subtree, parent});
+		}
+		Entry entry;
+		while (pending.pop(entry)) {
+			auto range = existing ? entries.equal_range(entry.node->value) : std::make_pair(entries.end(), entries.end());
+			auto it = range.first;
+			while ( (it != range.second) && (it->second.node != entry.node) ) {
+				++it;
+			}
+			if (it != range.second) {
+				it->second.parent = entry.parent;
+			} else {
+				entries.insert(std::make_pair(entry.node->value, entry));
+			}
+			if (entry.node->lChild) {
+				pending.push(Entry{entry.node->lChild, entry.node});
+			}
+			if (entry.node->rChild) {
+				pending.push(Entry{entry.node->rChild, entry.node});
+			}
+		}
+	}
+
+	std::unordered_multimap<T, Entry> entries;
+}; // CS : BinaryTreeIndex
+
+// BinaryTree names its children lChild and rChild.
+template <typename T>
+struct TreeLinks<BinaryTree<T> > {
+	template <typename N>
+	static auto left(N *node) -> decltype((node->lChild)) {return node->lChild;}
+	template <typename N>
+	static auto right(N *node) -> decltype((node->rChild)) {return node->rChild;}
+};
+
+template <typename T, typename V>
+T *findNodeWithValue(T *root, V value) {
+	T *match = nullptr;
+    
+	auto finder = [&match, &value] (T *node) -> bool {
+		if ( node && (node->value == value) ) {
+			match = node;
+            return true;// True indicates that we have accomplished our task and traversal can end prematurely.
+		}
+        return false;
+	};
+
+	inorderTraverse(root, finder);
+
+	return match;
+}
+
+/*
+ * This method returns a pointer to the parent node of the node with value 'value'. The problem
+ * with this scenario is that if the root contains 'value' then we do not have a parent. But another
+ * case where we cannot have a parent is if there is no node with value equal to 'value'. To
+ * differentiate between these two situations, it is not enough to just return the pointer to the parent
+ * but also to indicate, in case of failure, if the failure is a result of finding the value in the
+ * root node. We allow this by asking the caller to pass a reference to a bool which we will set
+ * to true, if value is found in the root. It will be set to false if no node contains the value.
+ * And it's value is false if we actually found the parent node. We return the parent node
+ * when found, and return nullptr otherwise.
+ */
+template <typename T, typename V>
+T *findParentOfNodeWithValue(T *root, V value, bool &foundValueInRoot) {
+	T *parent = nullptr;
+	if (root && root->value == value) {
+		foundValueInRoot = true;
+		return nullptr;
+	}
+	foundValueInRoot = false;// This parameter will not be changed in the rest of the code below.
+
+	auto finder = [&parent, &value] (T *node) -> bool {
+		if (node) {
+			T *l = tree_detail::left(node);
+			if (l && (l->value == value)) {
+				parent = node;
+                return true;
+			}
+			T *r = tree_detail::right(node);
+			if (r && (r->value == value)) {
+				parent = node;
+                return true;
+			}
+		}
+        return false;
+	};
+
+	inorderTraverse(root, finder);
+
+	return parent;
+}
+
+/*
+ * Looks up a batch of values in a single in-order traversal, instead of one traversal each. nodes[i] is what
+ * findNodeWithValue(root, values[i]) would return, and parents[i] is the parent of that node (null if it is the
+ * root or if there is no such node). The traversal stops as soon as every value has been found. V has to be
+ * hashable. Returns how many of the values were found.
+ */
+template <typename T, typename V>
+size_t findNodesWithValues(T *root, const std::vector<V> &values, std::vector<T *> &nodes, std::vector<T *> &parents) {
+	std::unordered_map<V, size_t> firstAsked; // Where each distinct value first appears in values.
+	for (size_t i = 0; i < values.size(); ++i) {
+		firstAsked.insert(std::make_pair(values[i], i));
+	}
+	nodes.assign(values.size(), nullptr);
+	parents.assign(values.size(), nullptr);
+	size_t missing = firstAsked.size();
+	struct Frame {
+		T *node;
+		T *parent;
+	};
+	Stack<Frame, 64> pending;
+	T *node = root, *parent = nullptr;
+	while (missing && (node || !pending.is_empty())) {
+		for (; node; parent = node, node = tree_detail::left(node)) {
+			pending.push(Frame{node, parent});
+		}
+		Frame frame = Frame{nullptr, nullptr};
+		pending.pop(frame);
+		auto it = firstAsked.find(frame.node->value);
+		if ( (it != firstAsked.end()) && !nodes[it->second] ) {
+			nodes[it->second] = frame.node;
+			parents[it->second] = frame.parent;
+			--missing;
+		}
+		parent = frame.node;
+		node = tree_detail::right(frame.node);
+	}
+	size_t found = 0;
+	for (size_t i = 0; i < values.size(); ++i) {
+		size_t first = firstAsked[values[i]];
+		nodes[i] = nodes[first];
+		parents[i] = parents[first];
+		found += (nodes[i] != nullptr);
+	}
+	return found;
+}
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_BINARY_TREE_H
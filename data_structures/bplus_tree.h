@@ -0,0 +1,555 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_BPLUS_TREE_H
+#define APFN_DATA_STRUCTURES_BPLUS_TREE_H
+
+#include <cstddef>      // size_t, std::ptrdiff_t
+#include <cstdint>      // uint32_t
+#include <algorithm>    // std::copy, std::copy_backward
+#include <iterator>     // std::forward_iterator_tag
+#include <utility>      // std::pair
+
+#include "stack.h"
+
+namespace vvalgo {
+
+    /*
+     * BPlusTree is an ordered map kept in nodes of about NodeBytes bytes each. An inner node holds up to
+     * INNER_CAPACITY separator keys side by side followed by its child pointers; a leaf holds up to LEAF_CAPACITY
+     * keys side by side, their values, and a link to the next leaf. With the default 512 bytes (eight cache lines)
+     * and 64-bit keys, an inner node has 31 keys, so a lookup in 100M keys reads 6 nodes where a red-black tree
+     * reads about 30. All the lines of a node are fetched at once, and the node is searched without branches.
+     * Scans in key order just follow the leaf links.
+     *
+     * Interface and semantics follow RB: keys are unique, find() returns nullptr for a missing key, insert()
+     * returns the value of the key whether it was just added or already there (and then leaves it alone), and
+     * remove() reports whether the key was there. Pointers returned by find() and insert(), and iterators, are
+     * invalidated by the next insert() or remove(), since keys move around inside and between nodes.
+     *
+     * Keys and values are copied around with assignment, so small trivially copyable types work best.
+     */
+    template <typename Key, typename Value, size_t NodeBytes = 512>
+    class BPlusTree {
+    private:
+        static const size_t HEADER_BYTES = sizeof(uint32_t) + sizeof(void *);
+        static const size_t LEAF_FIT = (NodeBytes - HEADER_BYTES) / (sizeof(Key) + sizeof(Value));
+        static const size_t INNER_FIT = (NodeBytes - HEADER_BYTES) / (sizeof(Key) + sizeof(void *));
+
+    public:
+        static const uint32_t LEAF_CAPACITY = (LEAF_FIT < 4) ? 4 : LEAF_FIT;
+        static const uint32_t INNER_CAPACITY = (INNER_FIT < 4) ? 4 : INNER_FIT; // Keys, so one more child.
+
+    private:
+        static const uint32_t LEAF_MIN = LEAF_CAPACITY / 2;
+        static const uint32_t INNER_MIN = INNER_CAPACITY / 2;
+        static const int MAX_LEVELS = 48; // A tree that deep would hold more keys than memory can.
+
+        struct Leaf {
+            uint32_t count;
+            Leaf *next;
+            Key keys[LEAF_CAPACITY];
+            Value values[LEAF_CAPACITY];
+            Leaf() : count(0), next(nullptr) {}
+        };
+
+        struct Inner {
+            uint32_t count; // Number of keys. There is one more child than that.
+            Key keys[INNER_CAPACITY];
+            void *children[INNER_CAPACITY + 1];
+            Inner() : count(0) {}
+        };
+
+        // An inner node on the way down, and which of its children we took.
+        struct Step {
+            Inner *node;
+            uint32_t child;
+        };
+
+    public:
+        struct Entry {
+            const Key &key;
+            const Value &value;
+        };
+
+        // Forward iterator over the entries in key order.
+        class ConstIterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Entry value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Entry *pointer;
+            typedef Entry reference;
+
+            ConstIterator() : leaf(nullptr), index(0) {}
+
+            const Key &key() const {return leaf->keys[index];}
+            const Value &value() const {return leaf->values[index];}
+            Entry operator*() const {return Entry{leaf->keys[index], leaf->values[index]};}
+
+            ConstIterator &operator++() {
+                ++index;
+                skipPastEnd();
+                return *this;
+            }
+
+            ConstIterator operator++(int) {
+                ConstIterator previous(*this);
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(const ConstIterator &other) const {return (leaf == other.leaf) && (index == other.index);}
+            bool operator!=(const ConstIterator &other) const {return !(*this == other);}
+
+        private:
+            friend class BPlusTree;
+            ConstIterator(const Leaf *l, uint32_t i) : leaf(l), index(i) {skipPastEnd();}
+
+            void skipPastEnd() {
+                while (leaf && (index >= leaf->count)) {
+                    leaf = leaf->next;
+                    index = 0;
+                }
+            }
+
+            const Leaf *leaf;
+            uint32_t index;
+        }; // CS : ConstIterator
+
+        BPlusTree() : root(new Leaf), levels(1), entries(0) {}
+
+        BPlusTree(const BPlusTree &) = delete;
+        BPlusTree &operator=(const BPlusTree &) = delete;
+
+        ~BPlusTree() {
+            clear();
+            delete static_cast<Leaf *>(root);
+        }
+
+        Value *find(const Key &key) {
+            Leaf *leaf = findLeaf(key);
+            uint32_t i = lowerBound(leaf->keys, leaf->count, key);
+            return ( (i < leaf->count) && !(key < leaf->keys[i]) ) ? &leaf->values[i] : nullptr;
+        }
+
+        const Value *find(const Key &key) const {return const_cast<BPlusTree *>(this)->find(key);}
+
+        Value *insert(const Key &key, const Value &value) {
+            Step path[MAX_LEVELS];
+            int depth = 0;
+            Leaf *leaf = descend(key, path, depth);
+            uint32_t i = lowerBound(leaf->keys, leaf->count, key);
+            if ( (i < leaf->count) && !(key < leaf->keys[i]) ) {
+                return &leaf->values[i];
+            }
+            ++entries;
+            if (leaf->count < LEAF_CAPACITY) {
+                insertIntoLeaf(leaf, i, key, value);
+                return &leaf->values[i];
+            }
+
+            // Split the full leaf in two and put the new entry in the half it belongs to.
+            Leaf *right = new Leaf;
+            uint32_t keep = LEAF_CAPACITY / 2;
+            right->count = leaf->count - keep;
+            std::copy(leaf->keys + keep, leaf->keys + leaf->count, right->keys);
+            std::copy(leaf->values + keep, leaf->values + leaf->count, right->values);
+            leaf->count = keep;
+            right->next = leaf->next;
+            leaf->next = right;
+            Value *result;
+            if (i <= keep) {
+                insertIntoLeaf(leaf, i, key, value);
+                result = &leaf->values[i];
+            } else {
+                insertIntoLeaf(right, i - keep, key, value);
+                result = &right->values[i - keep];
+            }
+
+            // Hand the new node and its first key up until some ancestor has room for them.
+            Key separator = right->keys[0];
+            void *newChild = right;
+            while (depth > 0) {
+                Step step = path[--depth];
+                Inner *inner = step.node;
+                if (inner->count < INNER_CAPACITY) {
+                    insertIntoInner(inner, step.child, separator, newChild);
+                    return result;
+                }
+                Key keys[INNER_CAPACITY + 1];
+                void *children[INNER_CAPACITY + 2];
+                std::copy(inner->keys, inner->keys + step.child, keys);
+                keys[step.child] = separator;
+                std::copy(inner->keys + step.child, inner->keys + inner->count, keys + step.child + 1);
+                std::copy(inner->children, inner->children + step.child + 1, children);
+                children[step.child + 1] = newChild;
+                std::copy(inner->children + step.child + 1, inner->children + inner->count + 1,
+                          children + step.child + 2);
+
+                uint32_t middle = (INNER_CAPACITY + 1) / 2; // This key moves up rather than to either half.
+                Inner *sibling = new Inner;
+                inner->count = middle;
+                std::copy(keys, keys + middle, inner->keys);
+                std::copy(children, children + middle + 1, inner->children);
+                sibling->count = INNER_CAPACITY - middle;
+                std::copy(keys + middle + 1, keys + INNER_CAPACITY + 1, sibling->keys);
+                std::copy(children + middle + 1, children + INNER_CAPACITY + 2, sibling->children);
+                separator = keys[middle];
+                newChild = sibling;
+            }
+            Inner *newRoot = new Inner; // The root itself split.
+            newRoot->count = 1;
+            newRoot->keys[0] = separator;
+            newRoot->children[0] = root;
+            newRoot->children[1] = newChild;
+            root = newRoot;
+            ++levels;
+            return result;
+        }
+
+        bool remove(const Key &key) {
+            Step path[MAX_LEVELS];
+            int depth = 0;
+            Leaf *leaf = descend(key, path, depth);
+            uint32_t i = lowerBound(leaf->keys, leaf->count, key);
+            if ( (i == leaf->count) || (key < leaf->keys[i]) ) {
+                return false;
+            }
+            --entries;
+            std::copy(leaf->keys + i + 1, leaf->keys + leaf->count, leaf->keys + i);
+            std::copy(leaf->values + i + 1, leaf->values + leaf->count, leaf->values + i);
+            --leaf->count;
+            if ( (leaf->count >= LEAF_MIN) || !depth ) { // The root leaf may hold any number of entries.
+                return true;
+            }
+
+            if (!rebalanceLeaf(path[depth - 1])) {
+                return true;
+            }
+            // The parent lost a key in a merge. Keep fixing inner nodes up the path while they are too small.
+            while (--depth > 0) {
+                if ( (path[depth].node->count >= INNER_MIN) || !rebalanceInner(path[depth - 1]) ) {
+                    return true;
+                }
+            }
+            Inner *top = static_cast<Inner *>(root);
+            if (!top->count) { // The root is down to a single child, which takes its place.
+                root = top->children[0];
+                delete top;
+                --levels;
+            }
+            return true;
+        }
+
+        ConstIterator begin() const {
+            const void *node = root;
+            for (int level = levels; level > 1; --level) {
+                node = static_cast<const Inner *>(node)->children[0];
+            }
+            return ConstIterator(static_cast<const Leaf *>(node), 0);
+        }
+
+        ConstIterator end() const {return ConstIterator();}
+
+        // First entry whose key is not less than key.
+        ConstIterator lowerBound(const Key &key) const {
+            const Leaf *leaf = const_cast<BPlusTree *>(this)->findLeaf(key);
+            return ConstIterator(leaf, lowerBound(leaf->keys, leaf->count, key));
+        }
+
+        size_t size() const {return entries;}
+        bool isEmpty() const {return entries == 0;}
+        int height() const {return levels;}
+
+        void clear() {
+            Stack<std::pair<void *, int>, 64> pending;
+            pending.push(std::make_pair(root, levels));
+            std::pair<void *, int> item;
+            while (pending.pop(item)) {
+                if (item.second == 1) {
+                    if (item.first != root) {
+                        delete static_cast<Leaf *>(item.first);
+                    }
+                    continue;
+                }
+                Inner *inner = static_cast<Inner *>(item.first);
+                for (uint32_t c = 0; c <= inner->count; ++c) {
+                    pending.push(std::make_pair(inner->children[c], item.second - 1));
+                }
+                delete inner;
+            }
+            if (levels > 1) {
+                root = new Leaf;
+            }
+            Leaf *leaf = static_cast<Leaf *>(root);
+            leaf->count = 0;
+            leaf->next = nullptr;
+            levels = 1;
+            entries = 0;
+        }
+
+        /*
+         * Checks that keys increase within and across nodes and respect the separators above them, that every
+         * node but the root is at least half full, that all leaves are at the same depth, and that the leaf chain
+         * holds every entry in order. Meant for tests: it visits the whole tree.
+         */
+        bool isValid() const {
+            struct Frame {
+                const void *node;
+                int level;
+                const Key *low;     // Keys in node must be >= *low and < *high, where they are not null.
+                const Key *high;
+            };
+            Stack<Frame, 64> pending;
+            pending.push(Frame{root, levels, nullptr, nullptr});
+            Frame frame;
+            size_t leafEntries = 0;
+            while (pending.pop(frame)) {
+                bool isRoot = (frame.node == root);
+                if (frame.level == 1) {
+                    const Leaf *leaf = static_cast<const Leaf *>(frame.node);
+                    if ( (!isRoot && (leaf->count < LEAF_MIN)) || (leaf->count > LEAF_CAPACITY) ||
+                         !inOrder(leaf->keys, leaf->count, frame.low, frame.high) ) {
+                        return false;
+                    }
+                    leafEntries += leaf->count;
+                    continue;
+                }
+                const Inner *inner = static_cast<const Inner *>(frame.node);
+                if ( (inner->count < (isRoot ? 1 : INNER_MIN)) || (inner->count > INNER_CAPACITY) ||
+                     !inOrder(inner->keys, inner->count, frame.low, frame.high) ) {
+                    return false;
+                }
+                for (uint32_t c = 0; c <= inner->count; ++c) {
+                    pending.push(Frame{inner->children[c], frame.level - 1,
+                                       c ? &inner->keys[c - 1] : frame.low,
+                                       (c < inner->count) ? &inner->keys[c] : frame.high});
+                }
+            }
+            size_t chained = 0;
+            const Key *previous = nullptr;
+            for (ConstIterator it = begin(); it != end(); ++it, ++chained) {
+                if (previous && !(*previous < it.key())) {
+                    return false;
+                }
+                previous = &it.key();
+            }
+            return (leafEntries == entries) && (chained == entries);
+        }
+
+    private:
+        // Number of keys[0, n) that are less than key, for sorted keys. Each step halves the range with a
+        // conditional move rather than a branch, so there are no mispredictions to pay for.
+        static uint32_t lowerBound(const Key *keys, uint32_t n, const Key &key) {
+            if (!n) {
+                return 0;
+            }
+            const Key *base = keys;
+            while (n > 1) {
+                uint32_t half = n / 2;
+                base = (base[half] < key) ? base + half : base;
+                n -= half;
+            }
+            return static_cast<uint32_t>(base - keys) + (*base < key);
+        }
+
+        // Number of keys[0, n) that are not greater than key.
+        static uint32_t upperBound(const Key *keys, uint32_t n, const Key &key) {
+            if (!n) {
+                return 0;
+            }
+            const Key *base = keys;
+            while (n > 1) {
+                uint32_t half = n / 2;
+                base = (key < base[half]) ? base : base + half;
+                n -= half;
+            }
+            return static_cast<uint32_t>(base - keys) + !(key < *base);
+        }
+
+        static bool inOrder(const Key *keys, uint32_t n, const Key *low, const Key *high) {
+            for (uint32_t i = 0; i < n; ++i) {
+                if ( (i && !(keys[i - 1] < keys[i])) || (low && (keys[i] < *low)) || (high && !(keys[i] < *high)) ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Asks for every cache line of a node at once, so that they arrive together rather than one after the
+        // other as the search in the node gets to them. Past a kilobyte the search touches only a few of the
+        // lines, and fetching the rest would just waste bandwidth.
+        template <typename Node>
+        static void prefetch(const Node *node) {
+#ifdef __GNUC__
+            if (sizeof(Node) > 1024) {
+                return;
+            }
+            const char *bytes = reinterpret_cast<const char *>(node);
+            for (size_t offset = 0; offset < sizeof(Node); offset += 64) {
+                __builtin_prefetch(bytes + offset);
+            }
+#else
+            (void)node;
+#endif
+        }
+
+        // Child c of an inner node holds the keys k with keys[c - 1] <= k < keys[c].
+        Leaf *findLeaf(const Key &key) {
+            void *node = root;
+            for (int level = levels; level > 1; --level) {
+                Inner *inner = static_cast<Inner *>(node);
+                prefetch(inner);
+                node = inner->children[upperBound(inner->keys, inner->count, key)];
+            }
+            prefetch(static_cast<Leaf *>(node));
+            return static_cast<Leaf *>(node);
+        }
+
+        Leaf *descend(const Key &key, Step *path, int &depth) {
+            void *node = root;
+            for (int level = levels; level > 1; --level) {
+                Inner *inner = static_cast<Inner *>(node);
+                uint32_t c = upperBound(inner->keys, inner->count, key);
+                path[depth++] = Step{inner, c};
+                node = inner->children[c];
+            }
+            return static_cast<Leaf *>(node);
+        }
+
+        static void insertIntoLeaf(Leaf *leaf, uint32_t i, const Key &key, const Value &value) {
+            std::copy_backward(leaf->keys + i, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::copy_backward(leaf->values + i, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+            leaf->keys[i] = key;
+            leaf->values[i] = value;
+            ++leaf->count;
+        }
+
+        // Puts separator at keys[i] and child right after it, at children[i + 1].
+        static void insertIntoInner(Inner *inner, uint32_t i, const Key &separator, void *child) {
+            std::copy_backward(inner->keys + i, inner->keys + inner->count, inner->keys + inner->count + 1);
+            std::copy_backward(inner->children + i + 1, inner->children + inner->count + 1,
+                               inner->children + inner->count + 2);
+            inner->keys[i] = separator;
+            inner->children[i + 1] = child;
+            ++inner->count;
+        }
+
+        // Takes out keys[i] and children[i + 1].
+        static void removeFromInner(Inner *inner, uint32_t i) {
+            std::copy(inner->keys + i + 1, inner->keys + inner->count, inner->keys + i);
+            std::copy(inner->children + i + 2, inner->children + inner->count + 1, inner->children + i + 1);
+            --inner->count;
+        }
+
+        // The leaf at step.child of step.node is short of entries. Borrows one from a sibling or merges with it.
+        // Returns true if it merged, which takes a key out of the parent.
+        bool rebalanceLeaf(const Step &step) {
+            Inner *parent = step.node;
+            uint32_t c = step.child;
+            Leaf *leaf = static_cast<Leaf *>(parent->children[c]);
+            Leaf *left = c ? static_cast<Leaf *>(parent->children[c - 1]) : nullptr;
+            Leaf *right = (c < parent->count) ? static_cast<Leaf *>(parent->children[c + 1]) : nullptr;
+            if (left && (left->count > LEAF_MIN)) {
+                --left->count;
+                insertIntoLeaf(leaf, 0, left->keys[left->count], left->values[left->count]);
+                parent->keys[c - 1] = leaf->keys[0];
+                return false;
+            }
+            if (right && (right->count > LEAF_MIN)) {
+                leaf->keys[leaf->count] = right->keys[0];
+                leaf->values[leaf->count] = right->values[0];
+                ++leaf->count;
+                std::copy(right->keys + 1, right->keys + right->count, right->keys);
+                std::copy(right->values + 1, right->values + right->count, right->values);
+                --right->count;
+                parent->keys[c] = right->keys[0];
+                return false;
+            }
+            if (left) { // Fold the leaf into its left sibling.
+                mergeLeaves(left, leaf);
+                removeFromInner(parent, c - 1);
+            } else {    // Fold the right sibling into the leaf.
+                mergeLeaves(leaf, right);
+                removeFromInner(parent, c);
+            }
+            return true;
+        }
+
+        static void mergeLeaves(Leaf *left, Leaf *right) {
+            std::copy(right->keys, right->keys + right->count, left->keys + left->count);
+            std::copy(right->values, right->values + right->count, left->values + left->count);
+            left->count += right->count;
+            left->next = right->next;
+            delete right;
+        }
+
+        // Same as rebalanceLeaf(), for an inner node. Keys pass through the parent on their way between siblings.
+        bool rebalanceInner(const Step &step) {
+            Inner *parent = step.node;
+            uint32_t c = step.child;
+            Inner *node = static_cast<Inner *>(parent->children[c]);
+            Inner *left = c ? static_cast<Inner *>(parent->children[c - 1]) : nullptr;
+            Inner *right = (c < parent->count) ? static_cast<Inner *>(parent->children[c + 1]) : nullptr;
+            if (left && (left->count > INNER_MIN)) {
+                std::copy_backward(node->keys, node->keys + node->count, node->keys + node->count + 1);
+                std::copy_backward(node->children, node->children + node->count + 1, node->children + node->count + 2);
+                node->keys[0] = parent->keys[c - 1];
+                node->children[0] = left->children[left->count];
+                ++node->count;
+                parent->keys[c - 1] = left->keys[left->count - 1];
+                --left->count;
+                return false;
+            }
+            if (right && (right->count > INNER_MIN)) {
+                node->keys[node->count] = parent->keys[c];
+                node->children[node->count + 1] = right->children[0];
+                ++node->count;
+                parent->keys[c] = right->keys[0];
+                std::copy(right->keys + 1, right->keys + right->count, right->keys);
+                std::copy(right->children + 1, right->children + right->count + 1, right->children);
+                --right->count;
+                return false;
+            }
+            if (left) {
+                mergeInners(left, parent->keys[c - 1], node);
+                removeFromInner(parent, c - 1);
+            } else {
+                mergeInners(node, parent->keys[c], right);
+                removeFromInner(parent, c);
+            }
+            return true;
+        }
+
+        static void mergeInners(Inner *left, const Key &separator, Inner *right) {
+            left->keys[left->count] = separator;
+            std::copy(right->keys, right->keys + right->count, left->keys + left->count + 1);
+            std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+            left->count += 1 + right->count;
+            delete right;
+        }
+
+        void *root;     // A Leaf when levels == 1, an Inner otherwise.
+        int levels;
+        size_t entries;
+    }; // CS : BPlusTree
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_BPLUS_TREE_H
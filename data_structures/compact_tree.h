@@ -0,0 +1,239 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_COMPACT_TREE_H
+#define APFN_DATA_STRUCTURES_COMPACT_TREE_H
+
+#include <cstdint>      // uint32_t
+#include <cstddef>      // size_t, std::nullptr_t
+#include <new>          // placement new
+#include <utility>      // std::forward
+#include <type_traits>  // std::aligned_storage
+
+#include "stack.h"
+#include "binary_search_tree.h"
+
+namespace vvalgo {
+
+    /*
+     * CompactArena<Node> is where every Node reached through a CompactPtr lives: chunks of CHUNK_NODES nodes
+     * that never move, addressed by a 32-bit index. Index 0 is never handed out and stands for nullptr.
+     * There is a single arena per node type for the whole program, which is what lets a 4 byte CompactPtr
+     * find its node without carrying a base pointer around. It is not thread-safe, and it can hold at most
+     * MAX_INDEX nodes because parent links keep a color in their top bit: past that, create() returns 0.
+     *
+     * The chunk table is a fixed array in static storage, initialized at compile time, so following a link
+     * costs one load from a small hot table and no check that the arena has been constructed.
+     */
+    template <typename Node>
+    class CompactArena {
+    public:
+        static const uint32_t CHUNK_SHIFT = 16;
+        static const uint32_t CHUNK_NODES = 1u << CHUNK_SHIFT;
+        static const uint32_t MAX_INDEX = 0x7FFFFFFF;
+
+        static const uint32_t MAX_CHUNKS = (MAX_INDEX >> CHUNK_SHIFT) + 1;
+
+        static CompactArena &instance() {return arena;}
+
+        CompactArena(const CompactArena &) = delete;
+        CompactArena &operator=(const CompactArena &) = delete;
+
+        ~CompactArena() {
+            for (uint32_t i = 0; i < chunkCount; ++i) {
+                delete[] chunks[i];
+            }
+        }
+
+        Node *at(uint32_t index) const {
+            return reinterpret_cast<Node *>(&chunks[index >> CHUNK_SHIFT][index & (CHUNK_NODES - 1)]);
+        }
+
+        template <typename... Args>
+        uint32_t create(Args&&... args) {
+            uint32_t index;
+            if (freeList) {
+                index = freeList;
+                freeList = reinterpret_cast<FreeSlot *>(at(index))->next;
+            } else {
+                if (next > MAX_INDEX) {
+                    return 0; // Full. Every index up to MAX_INDEX is within the MAX_CHUNKS chunks.
+                }
+                if ((next >> CHUNK_SHIFT) == chunkCount) {
+                    chunks[chunkCount++] = new Slot[CHUNK_NODES];
+                }
+                index = next++;
+            }
+            new (at(index)) Node(std::forward<Args>(args)...);
+            ++live;
+            return index;
+        }
+
+        void destroy(uint32_t index) {
+            Node *node = at(index);
+            node->~Node();
+            new (node) FreeSlot{freeList};
+            freeList = index;
+            --live;
+        }
+
+        size_t size() const {return live;}
+        size_t reservedBytes() const {return size_t(chunkCount) * CHUNK_NODES * sizeof(Slot);}
+
+    private:
+        constexpr CompactArena() : chunks(), chunkCount(0), next(1), freeList(0), live(0) {}
+
+        typedef typename std::aligned_storage<sizeof(Node), alignof(Node)>::type Slot;
+        struct FreeSlot {
+            uint32_t next;
+        };
+
+        static CompactArena arena;
+
+        Slot *chunks[MAX_CHUNKS];
+        uint32_t chunkCount;
+        uint32_t next;      // First index that has never been handed out.
+        uint32_t freeList;  // Destroyed nodes, linked through their first four bytes.
+        size_t live;
+    }; // CS : CompactArena
+
+    template <typename Node>
+    CompactArena<Node> CompactArena<Node>::arena;
+
+    /*
+     * A 32-bit stand-in for Node *, for nodes that live in CompactArena<Node>. It converts to Node * where a
+     * real pointer is needed (the traversal iterators, for instance), but a Node * cannot be turned back into
+     * a CompactPtr, so code that links nodes together has to work with CompactPtrs throughout, as the BST
+     * functions do.
+     */
+    template <typename Node>
+    class CompactPtr {
+    public:
+        CompactPtr() : index(0) {}
+        CompactPtr(std::nullptr_t) : index(0) {}
+
+        static CompactPtr fromIndex(uint32_t index) {
+            CompactPtr p;
+            p.index = index;
+            return p;
+        }
+        uint32_t toIndex() const {return index;}
+
+        Node *get() const {return index ? CompactArena<Node>::instance().at(index) : nullptr;}
+        operator Node *() const {return get();}
+        Node *operator->() const {return CompactArena<Node>::instance().at(index);}
+        Node &operator*() const {return *operator->();}
+
+        // Tests and comparisons only look at the index.
+        explicit operator bool() const {return index != 0;}
+        bool operator!() const {return index == 0;}
+        bool operator==(const CompactPtr &other) const {return index == other.index;}
+        bool operator!=(const CompactPtr &other) const {return index != other.index;}
+        bool operator==(std::nullptr_t) const {return index == 0;}
+        bool operator!=(std::nullptr_t) const {return index != 0;}
+
+    private:
+        uint32_t index;
+    }; // CS : CompactPtr
+
+    /*
+     * A parent link with the node's red/black color in its top bit. Assigning another node's parent link to it
+     * only moves the link: the color belongs to the node that holds it.
+     */
+    template <typename Node>
+    class CompactParent {
+    public:
+        CompactParent(CompactPtr<Node> p = nullptr) : bits(p.toIndex()) {}
+        CompactParent(const CompactParent &other) = default;
+
+        CompactParent &operator=(const CompactParent &other) {
+            bits = (bits & RED_BIT) | (other.bits & INDEX_MASK);
+            return *this;
+        }
+        CompactParent &operator=(CompactPtr<Node> p) {
+            bits = (bits & RED_BIT) | p.toIndex();
+            return *this;
+        }
+
+        CompactPtr<Node> get() const {return CompactPtr<Node>::fromIndex(bits & INDEX_MASK);}
+        operator CompactPtr<Node>() const {return get();}
+        Node *operator->() const {return get().operator->();}
+        explicit operator bool() const {return (bits & INDEX_MASK) != 0;}
+        bool operator!() const {return (bits & INDEX_MASK) == 0;}
+
+        bool isRed() const {return (bits & RED_BIT) != 0;}
+        void setRed(bool red) {bits = red ? (bits | RED_BIT) : (bits & INDEX_MASK);}
+
+    private:
+        static const uint32_t RED_BIT = 0x80000000;
+        static const uint32_t INDEX_MASK = 0x7FFFFFFF;
+        uint32_t bits;
+    }; // CS : CompactParent
+
+    /*
+     * Red-black tree node with 32-bit links: 16 bytes for an int value, against 32 bytes (plus the allocator's
+     * own overhead) for a node with three pointers. Nodes start out black.
+     */
+    template <typename ValueType>
+    struct CompactRBNode {
+        typedef CompactPtr<CompactRBNode> Ptr;
+
+        ValueType value;
+        Ptr left;
+        Ptr right;
+        CompactParent<CompactRBNode> parent;
+
+        CompactRBNode(ValueType val, Ptr l = nullptr, Ptr r = nullptr, Ptr p = nullptr)
+            : value(val), left(l), right(r), parent(p) {}
+
+        bool isRed() const {return parent.isRed();}
+        void setRed(bool red) {parent.setRed(red);}
+    }; // CS : CompactRBNode
+
+    template <typename Node>
+    struct NodePtrTraits<CompactPtr<Node> > {
+        template <typename... Args>
+        static CompactPtr<Node> create(Args&&... args) {
+            return CompactPtr<Node>::fromIndex(CompactArena<Node>::instance().create(std::forward<Args>(args)...));
+        }
+
+        static void destroy(CompactPtr<Node> node) {CompactArena<Node>::instance().destroy(node.toIndex());}
+    };
+
+    // Returns all the nodes of a tree to the arena, without recursion.
+    template <typename Node>
+    void destroyTree(CompactPtr<Node> root) {
+        Stack<CompactPtr<Node>, 32> pending;
+        if (root) {
+            pending.push(root);
+        }
+        CompactPtr<Node> node;
+        while (pending.pop(node)) {
+            if (node->left) {
+                pending.push(node->left);
+            }
+            if (node->right) {
+                pending.push(node->right);
+            }
+            NodePtrTraits<CompactPtr<Node> >::destroy(node);
+        }
+    }
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_COMPACT_TREE_H
@@ -0,0 +1,328 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_CONCURRENT_HEAP_H
+#define APFN_DATA_STRUCTURES_CONCURRENT_HEAP_H
+
+#include <vector>       // backing store for the shards and the node array.
+#include <functional>   // std::less (the default ordering predicate)
+#include <mutex>        // std::mutex, std::lock_guard
+#include <atomic>       // std::atomic for the approximate element count.
+#include <random>       // std::minstd_rand for picking shards.
+#include <thread>       // std::this_thread::get_id to seed the per thread generator.
+#include <algorithm>    // std::swap
+#include <memory>       // std::unique_ptr for the shard array.
+
+#include "heap.h"       // vvalgo::heap algorithms.
+
+namespace vvalgo {
+    
+    namespace concurrent_heap_detail {
+        // Each thread keeps its own generator so that picking a shard never needs synchronization.
+        inline std::minstd_rand &threadRandom() {
+            thread_local std::minstd_rand generator(static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+            return generator;
+        }
+    } // NS : concurrent_heap_detail
+    
+    /*
+     * MultiQueue is a relaxed concurrent priority queue. It keeps c * p independent heaps ("shards"), each
+     * protected by its own lock, where p is the expected number of threads.
+     * - insert() pushes into a random shard whose lock is free.
+     * - popHead() locks two random shards and pops from whichever has the better head.
+     * Threads rarely meet on the same lock, so throughput scales with the thread count. The price is that the
+     * popped element is not always the global head. Its expected rank error is O(number of shards).
+     *
+     * popHead() takes the popped value as an out parameter because a separate peekHead() followed by popHead()
+     * cannot be atomic once other threads are involved.
+     */
+    template <typename ValueType, typename OrderPredicate = std::less<ValueType> >
+    class MultiQueue {
+    public:
+        MultiQueue(size_t threads, size_t shardsPerThread = 2, OrderPredicate op = OrderPredicate())
+        : shardCount(std::max<size_t>(2, threads * shardsPerThread)), shards(new Shard[shardCount]), count(0), orderPredicate(op) {}
+        
+        // Inserts a new element into one of the shards.
+        void insert(const ValueType &element) {
+            Shard &shard = lockRandomShard();
+            shard.storage.push_back(element);
+            heap::pushHeap(shard.storage.begin(), shard.storage.end(), orderPredicate);
+            ++count;
+            shard.lock.unlock();
+        }
+        
+        // Pops an element close to the head into 'head'. Returns false only if every shard was found empty.
+        bool popHead(ValueType &head) {
+            auto &generator = concurrent_heap_detail::threadRandom();
+            // Two random choices work as long as there are plenty of elements. Once the queue runs low we fall
+            // back to a scan so that we never report an empty queue while some shard still holds elements.
+            for (int attempt = 0; attempt < 4 && count.load(std::memory_order_relaxed) > 0; ++attempt) {
+                size_t i = generator() % shardCount;
+                size_t j = generator() % (shardCount - 1);
+                j += (j >= i); // j != i
+                if (i > j) { // Lock in index order so that two poppers can never deadlock.
+                    std::swap(i, j);
+                }
+                std::lock_guard<std::mutex> lockI(shards[i].lock);
+                std::lock_guard<std::mutex> lockJ(shards[j].lock);
+                Shard *better = pickBetter(shards[i], shards[j]);
+                if (better) {
+                    pop(*better, head);
+                    return true;
+                }
+            }
+            for (size_t i = 0; i < shardCount; ++i) {
+                std::lock_guard<std::mutex> guard(shards[i].lock);
+                if (!shards[i].storage.empty()) {
+                    pop(shards[i], head);
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+        // Copies the best head among all the shards. This is O(shards) and only a snapshot: by the time it
+        // returns another thread may already have popped that element.
+        bool peekHead(ValueType &head) {
+            bool found = false;
+            for (size_t i = 0; i < shardCount; ++i) {
+                std::lock_guard<std::mutex> guard(shards[i].lock);
+                if (!shards[i].storage.empty() && (!found || orderPredicate(shards[i].storage[0], head))) {
+                    head = shards[i].storage[0];
+                    found = true;
+                }
+            }
+            return found;
+        }
+        
+        // Both of these are exact only when no other thread is modifying the queue.
+        bool isEmpty() const {return count.load() == 0;}
+        size_t size() const {return count.load();}
+        
+    private:
+        struct Shard {
+            std::mutex lock;
+            std::vector<ValueType> storage;
+            char padding[64]; // Keeps neighbouring shards' locks off the same cache line.
+        };
+        
+        Shard &lockRandomShard() {
+            auto &generator = concurrent_heap_detail::threadRandom();
+            while (true) {
+                Shard &shard = shards[generator() % shardCount];
+                if (shard.lock.try_lock()) {
+                    return shard;
+                }
+            }
+        }
+        
+        // Both shards must be locked. Returns nullptr if both are empty.
+        Shard *pickBetter(Shard &a, Shard &b) {
+            if (a.storage.empty()) {
+                return b.storage.empty() ? nullptr : &b;
+            }
+            if (b.storage.empty()) {
+                return &a;
+            }
+            return orderPredicate(b.storage[0], a.storage[0]) ? &b : &a;
+        }
+        
+        // The shard must be locked and non-empty.
+        void pop(Shard &shard, ValueType &head) {
+            head = shard.storage[0];
+            heap::extractHead(shard.storage.begin(), shard.storage.end(), orderPredicate);
+            shard.storage.pop_back();
+            --count;
+        }
+        
+        size_t shardCount;
+        std::unique_ptr<Shard[]> shards;
+        std::atomic<size_t> count;
+        OrderPredicate orderPredicate;
+    }; // CS : MultiQueue
+    
+    /*
+     * FineGrainedHeap is a strict (linearizable) concurrent priority queue based on the heap of Hunt, Michael,
+     * Parthasarathy and Scott. Instead of one lock around the whole heap, every slot of the array has its own
+     * lock and a tag:
+     * - EMPTY:     the slot is not part of the heap.
+     * - AVAILABLE: the slot holds an element that is in its final place as far as its inserter is concerned.
+     * - otherwise: the id of the insertion that is still sifting this element up.
+     * A short global lock only protects the size. insert() sifts bottom-up and popHead() sifts top-down, both
+     * holding at most two slot locks at a time and always locking a parent before its child, so operations on
+     * different parts of the heap proceed in parallel and cannot deadlock.
+     *
+     * The capacity is fixed at construction. insert() returns false when the heap is full.
+     */
+    template <typename ValueType, typename OrderPredicate = std::less<ValueType> >
+    class FineGrainedHeap {
+    public:
+        FineGrainedHeap(size_t capacity, OrderPredicate op = OrderPredicate())
+        : capacity(capacity), nodes(new Node[capacity + 1]), size_(0), nextInsertionId(FIRST_INSERTION_ID), orderPredicate(op) {}
+        
+        bool insert(const ValueType &element) {
+            unsigned long long myId = nextInsertionId.fetch_add(1);
+            heapLock.lock();
+            if (size_ == capacity) {
+                heapLock.unlock();
+                return false;
+            }
+            size_t i = ++size_;
+            nodes[i].lock.lock();
+            heapLock.unlock();
+            nodes[i].value = element;
+            nodes[i].tag = myId;
+            nodes[i].lock.unlock();
+            
+            while (i > 1) {
+                size_t p = i / 2;
+                size_t oldI = i;
+                nodes[p].lock.lock();
+                nodes[i].lock.lock();
+                if ( (nodes[p].tag == AVAILABLE) && (nodes[i].tag == myId) ) {
+                    if (orderPredicate(nodes[i].value, nodes[p].value)) {
+                        swapNodes(nodes[i], nodes[p]);
+                        i = p;
+                    } else {
+                        nodes[i].tag = AVAILABLE;
+                        i = 0;
+                    }
+                } else if (nodes[p].tag == EMPTY) { // A popHead() has moved our element to the root.
+                    i = 0;
+                } else if (nodes[i].tag != myId) {  // A popHead() sifting down has moved our element up.
+                    i = p;
+                }
+                nodes[oldI].lock.unlock();
+                nodes[p].lock.unlock();
+                if (i == oldI) { // The parent belongs to an insertion in progress. Let it finish before we retry.
+                    std::this_thread::yield();
+                }
+            }
+            if (i == 1) {
+                std::lock_guard<std::mutex> guard(nodes[1].lock);
+                if (nodes[1].tag == myId) {
+                    nodes[1].tag = AVAILABLE;
+                }
+            }
+            return true;
+        }
+        
+        // Pops the head into 'head'. Returns false if the heap is empty.
+        bool popHead(ValueType &head) {
+            heapLock.lock();
+            if (size_ == 0) {
+                heapLock.unlock();
+                return false;
+            }
+            // The bottom element moves to the root under both slot locks, taken (root first, as a parent before
+            // its child) while the size is still locked, so it is in some slot at every moment and no other pop
+            // can get past the root until it is there. This is Herlihy and Shavit's removeMin.
+            size_t bottom = size_--;
+            nodes[1].lock.lock();
+            if (bottom != 1) {
+                nodes[bottom].lock.lock();
+            }
+            heapLock.unlock();
+            head = nodes[1].value;
+            if (bottom == 1) {
+                nodes[1].tag = EMPTY;
+                nodes[1].lock.unlock();
+                return true;
+            }
+            nodes[1].value = nodes[bottom].value;
+            nodes[1].tag = AVAILABLE; // An insertion still sifting it up finds its tag gone and stops.
+            nodes[bottom].tag = EMPTY;
+            nodes[bottom].lock.unlock();
+            
+            size_t i = 1;
+            while (2 * i <= capacity) {
+                size_t left = 2 * i;
+                size_t right = left + 1;
+                nodes[left].lock.lock();
+                if (nodes[left].tag == EMPTY) { // Heap is complete, so no left child means no right child either.
+                    nodes[left].lock.unlock();
+                    break;
+                }
+                size_t child = left;
+                if (right <= capacity) {
+                    nodes[right].lock.lock();
+                    if ( (nodes[right].tag != EMPTY) && orderPredicate(nodes[right].value, nodes[left].value) ) {
+                        nodes[left].lock.unlock();
+                        child = right;
+                    } else {
+                        nodes[right].lock.unlock();
+                    }
+                }
+                if (!orderPredicate(nodes[child].value, nodes[i].value)) {
+                    nodes[child].lock.unlock();
+                    break;
+                }
+                swapNodes(nodes[child], nodes[i]);
+                nodes[i].lock.unlock();
+                i = child;
+            }
+            nodes[i].lock.unlock();
+            return true;
+        }
+        
+        bool peekHead(ValueType &head) {
+            std::lock_guard<std::mutex> guard(nodes[1].lock);
+            if (nodes[1].tag == EMPTY) {
+                return false;
+            }
+            head = nodes[1].value;
+            return true;
+        }
+        
+        bool isEmpty() {
+            std::lock_guard<std::mutex> guard(heapLock);
+            return size_ == 0;
+        }
+        
+        size_t size() {
+            std::lock_guard<std::mutex> guard(heapLock);
+            return size_;
+        }
+        
+    private:
+        static const unsigned long long EMPTY = 0;
+        static const unsigned long long AVAILABLE = 1;
+        static const unsigned long long FIRST_INSERTION_ID = 2;
+        
+        struct Node { // Index 0 is unused so that the children of i are 2i and 2i + 1.
+            std::mutex lock;
+            unsigned long long tag = EMPTY;
+            ValueType value;
+        };
+        
+        static void swapNodes(Node &a, Node &b) {
+            std::swap(a.value, b.value);
+            std::swap(a.tag, b.tag);
+        }
+        
+        size_t capacity;
+        std::unique_ptr<Node[]> nodes;
+        std::mutex heapLock;
+        size_t size_;
+        std::atomic<unsigned long long> nextInsertionId;
+        OrderPredicate orderPredicate;
+    }; // CS : FineGrainedHeap
+    
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_CONCURRENT_HEAP_H
@@ -0,0 +1,159 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_CONCURRENT_ORDERED_MAP_H
+#define APFN_DATA_STRUCTURES_CONCURRENT_ORDERED_MAP_H
+
+#include <atomic>   // The root pointer and the size.
+#include <mutex>    // Writers take turns.
+#include <vector>   // Nodes replaced by an update.
+#include <cstddef>  // size_t
+
+#include "stack.h"
+#include "epoch.h"
+#include "persistent_red_black_tree.h"
+
+namespace vvalgo {
+
+    /*
+     * ConcurrentOrderedMap is a red-black tree for read-mostly workloads. Readers take no locks and write no
+     * shared memory except their own epoch slot, so they scale with the number of cores.
+     *
+     * Nodes never change once they are reachable. An update path-copies (see FRB in persistent_red_black_tree.h)
+     * and then swaps the new root in with a single atomic store. A reader therefore sees the whole tree before or
+     * after any update, never half of one. The nodes the update replaced go to an EpochDomain, which frees them
+     * once no reader can still be looking at them. Writers take a mutex, and each update allocates O(log n) nodes.
+     *
+     * Keys are unique: insert() leaves an existing key alone and returns false. find() copies the value out,
+     * since the node it was in may be freed as soon as find() returns.
+     */
+    template <typename Key, typename Value>
+    class ConcurrentOrderedMap {
+    public:
+        ConcurrentOrderedMap() : root(nullptr), entries(0) {}
+
+        ConcurrentOrderedMap(const ConcurrentOrderedMap &) = delete;
+        ConcurrentOrderedMap &operator=(const ConcurrentOrderedMap &) = delete;
+
+        // No other thread may be using the map any more.
+        ~ConcurrentOrderedMap() {
+            Stack<Node *, 64> pending;
+            if (Node *top = root.load(std::memory_order_relaxed)) {
+                pending.push(top);
+            }
+            Node *node;
+            while (pending.pop(node)) {
+                if (node->left) {
+                    pending.push(node->left);
+                }
+                if (node->right) {
+                    pending.push(node->right);
+                }
+                delete node;
+            }
+        }
+
+        bool find(const Key &key, Value &value) const {
+            EpochDomain::ReadGuard guard(epochs);
+            const Node *node = FRB::lookup(root.load(), key);
+            if (node) {
+                value = node->value;
+            }
+            return node != nullptr;
+        }
+
+        bool contains(const Key &key) const {
+            EpochDomain::ReadGuard guard(epochs);
+            return FRB::lookup(root.load(), key) != nullptr;
+        }
+
+        bool insert(const Key &key, const Value &value) {
+            std::lock_guard<std::mutex> guard(writer);
+            Node *top = root.load(std::memory_order_relaxed);
+            if (FRB::lookup(top, key)) {
+                return false;
+            }
+            publish(FRB::PathCopy<Builder>(builder).insert(top, key, value));
+            entries.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool remove(const Key &key) {
+            std::lock_guard<std::mutex> guard(writer);
+            Node *top = root.load(std::memory_order_relaxed);
+            if (!FRB::lookup(top, key)) {
+                return false;
+            }
+            publish(FRB::PathCopy<Builder>(builder).remove(top, key));
+            entries.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        size_t size() const {return entries.load(std::memory_order_relaxed);}
+
+        // Checks the red-black invariants and the key order. Meant for tests, with no writer running.
+        bool isValid() const {
+            EpochDomain::ReadGuard guard(epochs);
+            size_t count;
+            return FRB::isValid(root.load(), count) && (count == size());
+        }
+
+    private:
+        struct Node {
+            Key key;
+            Value value;
+            bool red;
+            Node *left;
+            Node *right;
+            Node(const Key &k, const Value &v, bool r, Node *l, Node *rt) : key(k), value(v), red(r), left(l), right(rt) {}
+        };
+
+        // Makes nodes with new, and keeps the ones an update replaces until it has published the new root.
+        struct Builder {
+            typedef Node *NodeRef;
+            Node *make(const Key &key, const Value &value) {return new Node(key, value, true, nullptr, nullptr);}
+            Node *make(bool red, Node *left, Node *entry, Node *right) {
+                return new Node(entry->key, entry->value, red, left, right);
+            }
+            void consume(Node *node) {replaced.push_back(node);}
+            std::vector<Node *> replaced;
+        };
+
+        void publish(Node *top) {
+            root.store(top); // Sequentially consistent: see EpochDomain::ReadGuard.
+            for (Node *node : builder.replaced) {
+                epochs.retire(node);
+            }
+            builder.replaced.clear();
+            if (epochs.pending() >= RECLAIM_BATCH) {
+                epochs.reclaim();
+            }
+        }
+
+        static const size_t RECLAIM_BATCH = 1024; // Retired nodes to collect before looking for readers.
+
+        std::atomic<Node *> root;
+        std::atomic<size_t> entries;
+        std::mutex writer;
+        Builder builder;
+        mutable EpochDomain epochs;
+    }; // CS : ConcurrentOrderedMap
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_CONCURRENT_ORDERED_MAP_H
@@ -0,0 +1,324 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_CONCURRENT_STACK_H
+#define APFN_DATA_STRUCTURES_CONCURRENT_STACK_H
+
+#include <atomic>       // std::atomic for the tagged head, the links and the elimination slots.
+#include <mutex>        // std::mutex, only taken on the rare path that grows the node pool.
+#include <random>       // std::minstd_rand for picking an elimination slot.
+#include <thread>       // std::this_thread::get_id to seed the per thread generator.
+#include <functional>   // std::hash
+#include <cstdint>      // uint32_t, uint64_t
+#include <cstring>      // std::memcpy for peek()
+#include <new>          // placement new
+#include <utility>      // std::move, std::forward
+#include <type_traits>  // std::is_trivially_copyable
+
+namespace vvalgo {
+
+/*
+ * ConcurrentStack is a lock-free Treiber stack with an elimination-backoff array, keeping the
+ * push/pop/peek/is_empty surface of Stack. Any number of threads may use it at the same time.
+ *
+ * ABA: nodes are addressed by 32-bit indices, and the head packs the index of the top node together with a
+ * 32-bit tag that is bumped on every successful update. A pop that read a stale head therefore fails its
+ * compare-and-swap even if the same node index has been pushed again in the meantime.
+ *
+ * Reclamation: popped nodes go back to an internal free list, which is itself a tagged Treiber stack, and are
+ * reused by later pushes. Node memory only goes back to the system when the ConcurrentStack is destroyed: a
+ * stack that once held a million items keeps a million nodes until then. In exchange, a thread that still
+ * holds the index of a popped node can always read its link safely. This is what hazard pointers or epochs
+ * would otherwise have to guarantee, and it costs nothing on the fast path. The pool grows in doubling
+ * chunks, so existing nodes never move, up to MAX_CHUNKS of them (about 4 billion nodes); once those are all
+ * in use, push() fails.
+ *
+ * Elimination: when the compare-and-swap on the head fails because of contention, a push and a pop can meet
+ * in a random slot of a small array and hand the item over directly without touching the head at all.
+ */
+template <typename T>
+class ConcurrentStack {
+public:
+ConcurrentStack() : head(0), freeList(0), chunkCount(0) {
+	for (auto &chunk : chunks) {
+		chunk.store(nullptr, std::memory_order_relaxed);
+	}
+	for (auto &slot : eliminationSlots) {
+		slot.value.store(EMPTY_SLOT, std::memory_order_relaxed);
+	}
+}
+
+ConcurrentStack(const ConcurrentStack &) = delete;
+ConcurrentStack &operator=(const ConcurrentStack &) = delete;
+
+~ConcurrentStack() { // No other thread may be using the stack any more.
+	while (pop()) {
+	}
+	for (int c = 0; c < chunkCount; ++c) {
+		delete [] chunks[c].load(std::memory_order_relaxed);
+	}
+}
+
+// Returns false, and leaves the stack as it was, only if every node the pool can address is in use.
+bool push(const T &item) {
+	return emplace(item);
+}
+
+bool push(T &&item) {
+	return emplace(std::move(item));
+}
+
+template <typename... Args>
+bool emplace(Args&&... args) {
+	uint32_t index = allocateNode();
+	if (index == NIL) {
+		return false;
+	}
+	Node &n = node(index);
+	n.version.fetch_add(1, std::memory_order_relaxed); // Odd: value under construction (see peek()).
+	std::atomic_thread_fence(std::memory_order_release);
+	new (n.slot()) T(std::forward<Args>(args)...);
+	n.version.fetch_add(1, std::memory_order_release); // Even again: value stable.
+	while (true) {
+		uint64_t top = head.load(std::memory_order_acquire);
+		n.next.store(indexOf(top), std::memory_order_relaxed);
+		if (head.compare_exchange_weak(top, pack(index, tagOf(top) + 1), std::memory_order_release, std::memory_order_relaxed)) {
+			return true;
+		}
+		if (offerForElimination(index)) {
+			return true;
+		}
+	}
+}
+
+// Discards the top item. Returns false if the stack was empty.
+bool pop() {
+	uint32_t index = takeNode();
+	if (index == NIL) {
+		return false;
+	}
+	node(index).slot()->~T();
+	freeNode(index);
+	return true;
+}
+
+// Moves the top item into item and pops it. Returns false if the stack was empty.
+bool pop(T &item) {
+	uint32_t index = takeNode();
+	if (index == NIL) {
+		return false;
+	}
+	T *value = node(index).slot();
+	item = std::move(*value);
+	value->~T();
+	freeNode(index);
+	return true;
+}
+
+// Copies the current top item without popping it. Since another thread may pop and reuse that node while
+// we copy, this is only offered for trivially copyable items and uses a per node version counter to detect
+// a torn copy (a seqlock). The result is the top at some instant during the call.
+bool peek(T &item) const {
+	static_assert(std::is_trivially_copyable<T>::value, "ConcurrentStack::peek() needs a trivially copyable T");
+	while (true) {
+		uint64_t top = head.load(std::memory_order_acquire);
+		if (indexOf(top) == NIL) {
+			return false;
+		}
+		const Node &n = node(indexOf(top));
+		uint32_t before = n.version.load(std::memory_order_acquire);
+		alignas(T) unsigned char copy[sizeof(T)];
+		std::memcpy(copy, n.value, sizeof(T));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint32_t after = n.version.load(std::memory_order_relaxed);
+		if ( (before % 2 == 0) && (before == after) && (head.load(std::memory_order_relaxed) == top) ) {
+			std::memcpy(&item, copy, sizeof(T));
+			return true;
+		}
+	}
+}
+
+bool is_empty() const {
+	return indexOf(head.load(std::memory_order_acquire)) == NIL;
+}
+
+private:
+static const uint32_t NIL = 0;                 // Index 0 is never handed out, so it doubles as nullptr.
+static const uint32_t FIRST_CHUNK_SIZE = 1024;
+static const int MAX_CHUNKS = 22;              // Chunk c holds FIRST_CHUNK_SIZE << c nodes: about 4 billion in all.
+static const int ELIMINATION_SLOTS = 8;
+static const int ELIMINATION_SPINS = 64;
+static const uint64_t EMPTY_SLOT = 0;
+static const uint64_t TAKEN_SLOT = 1ULL << 62;  // A pop has taken the offered node. Only its pusher resets the slot.
+static const uint64_t OFFERED = 1ULL << 63;     // A push is offering the node whose index is in the low 32 bits.
+
+struct Node {
+	std::atomic<uint32_t> next;
+	std::atomic<uint32_t> version; // Odd while the value is being constructed.
+	alignas(T) unsigned char value[sizeof(T)];
+	Node() : next(NIL), version(0) {}
+	T *slot() {return reinterpret_cast<T *>(value);}
+};
+
+struct EliminationSlot {
+	std::atomic<uint64_t> value;
+	char padding[64 - sizeof(std::atomic<uint64_t>)]; // One slot per cache line.
+};
+
+// head and freeList pack (tag << 32) | index.
+static uint64_t pack(uint32_t index, uint32_t tag) {return (static_cast<uint64_t>(tag) << 32) | index;}
+static uint32_t indexOf(uint64_t tagged) {return static_cast<uint32_t>(tagged);}
+static uint32_t tagOf(uint64_t tagged) {return static_cast<uint32_t>(tagged >> 32);}
+
+static std::minstd_rand &threadRandom() {
+	thread_local std::minstd_rand generator(static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+	return generator;
+}
+
+// Maps a node index to its chunk. Chunk c starts at index FIRST_CHUNK_SIZE * (2^c - 1) + 1.
+Node &node(uint32_t index) const {
+	uint64_t scaled = (static_cast<uint64_t>(index) - 1) / FIRST_CHUNK_SIZE + 1;
+#ifdef __GNUC__
+	int c = 63 - __builtin_clzll(scaled);
+#else
+	int c = 0;
+	while (scaled >>= 1) {
+		++c;
+	}
+#endif
+	uint64_t chunkStart = static_cast<uint64_t>(FIRST_CHUNK_SIZE) * ((1ULL << c) - 1) + 1;
+	return chunks[c].load(std::memory_order_acquire)[index - chunkStart];
+}
+
+// Pops the top node off the stack (or out of an elimination slot) and returns its index, or NIL if empty.
+uint32_t takeNode() {
+	while (true) {
+		uint64_t top = head.load(std::memory_order_acquire);
+		uint32_t index = indexOf(top);
+		if (index == NIL) {
+			return NIL;
+		}
+		uint32_t next = node(index).next.load(std::memory_order_relaxed);
+		if (head.compare_exchange_weak(top, pack(next, tagOf(top) + 1), std::memory_order_acquire, std::memory_order_relaxed)) {
+			return index;
+		}
+		uint32_t eliminated = takeFromElimination();
+		if (eliminated != NIL) {
+			return eliminated;
+		}
+	}
+}
+
+bool offerForElimination(uint32_t index) {
+	std::atomic<uint64_t> &slot = eliminationSlots[threadRandom()() % ELIMINATION_SLOTS].value;
+	uint64_t expected = EMPTY_SLOT;
+	uint64_t offer = OFFERED | index;
+	if (!slot.compare_exchange_strong(expected, offer, std::memory_order_release, std::memory_order_relaxed)) {
+		return false;
+	}
+	for (int spin = 0; spin < ELIMINATION_SPINS; ++spin) {
+		if (slot.load(std::memory_order_acquire) == TAKEN_SLOT) {
+			slot.store(EMPTY_SLOT, std::memory_order_release);
+			return true;
+		}
+	}
+	if (slot.compare_exchange_strong(offer, EMPTY_SLOT, std::memory_order_acquire, std::memory_order_acquire)) {
+		return false; // Nobody came, so we withdraw and try the head again.
+	}
+	slot.store(EMPTY_SLOT, std::memory_order_release); // A pop took it just before we withdrew.
+	return true;
+}
+
+uint32_t takeFromElimination() {
+	std::atomic<uint64_t> &slot = eliminationSlots[threadRandom()() % ELIMINATION_SLOTS].value;
+	uint64_t offer = slot.load(std::memory_order_acquire);
+	if ( (offer & OFFERED) && slot.compare_exchange_strong(offer, TAKEN_SLOT, std::memory_order_acq_rel, std::memory_order_relaxed) ) {
+		return indexOf(offer);
+	}
+	return NIL;
+}
+
+// Returns NIL if the pool is exhausted.
+uint32_t allocateNode() {
+	while (true) {
+		uint64_t top = freeList.load(std::memory_order_acquire);
+		uint32_t index = indexOf(top);
+		if (index == NIL) {
+			if (!grow()) {
+				return NIL;
+			}
+			continue;
+		}
+		uint32_t next = node(index).next.load(std::memory_order_relaxed);
+		if (freeList.compare_exchange_weak(top, pack(next, tagOf(top) + 1), std::memory_order_acquire, std::memory_order_relaxed)) {
+			return index;
+		}
+	}
+}
+
+void freeNode(uint32_t index) {
+	pushFreeList(index, index);
+}
+
+// Pushes the already linked run of nodes first..last onto the free list.
+void pushFreeList(uint32_t first, uint32_t last) {
+	Node &lastNode = node(last);
+	while (true) {
+		uint64_t top = freeList.load(std::memory_order_relaxed);
+		lastNode.next.store(indexOf(top), std::memory_order_relaxed);
+		if (freeList.compare_exchange_weak(top, pack(first, tagOf(top) + 1), std::memory_order_release, std::memory_order_relaxed)) {
+			return;
+		}
+	}
+}
+
+// Adds the next chunk of nodes to the free list. Serialised by a lock, but only runs when the pool is empty.
+// Returns false if there is no free node and the chunk table is full.
+bool grow() {
+	std::lock_guard<std::mutex> guard(growLock);
+	if (indexOf(freeList.load(std::memory_order_acquire)) != NIL) {
+		return true; // Another thread grew the pool or freed a node while we waited.
+	}
+	if (chunkCount == MAX_CHUNKS) {
+		return false; // Chunk MAX_CHUNKS would not fit the table, and its indices would not fit 32 bits.
+	}
+	int c = chunkCount;
+	uint32_t size = FIRST_CHUNK_SIZE << c;
+	uint32_t first = FIRST_CHUNK_SIZE * ((1U << c) - 1) + 1;
+	Node *chunk = new Node[size];
+	for (uint32_t i = 0; i + 1 < size; ++i) {
+		chunk[i].next.store(first + i + 1, std::memory_order_relaxed);
+	}
+	chunks[c].store(chunk, std::memory_order_release);
+	++chunkCount;
+	pushFreeList(first, first + size - 1);
+	return true;
+}
+
+std::atomic<uint64_t> head;
+char headPadding[64]; // Keep the contended head and free list on different cache lines.
+std::atomic<uint64_t> freeList;
+mutable std::atomic<Node *> chunks[MAX_CHUNKS];
+int chunkCount;
+std::mutex growLock;
+EliminationSlot eliminationSlots[ELIMINATION_SLOTS];
+};
+
+}
+
+#endif // APFN_DATA_STRUCTURES_CONCURRENT_STACK_H
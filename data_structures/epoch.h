@@ -0,0 +1,200 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_EPOCH_H
+#define APFN_DATA_STRUCTURES_EPOCH_H
+
+#include <atomic>   // Epochs and reader slots.
+#include <cstdint>  // uint64_t
+#include <deque>    // Retired objects, oldest first.
+#include <mutex>    // std::mutex for the thread registry.
+
+namespace vvalgo {
+
+    namespace epoch_detail {
+        const int MAX_THREADS = 128;
+
+        // Hands out thread numbers below MAX_THREADS to the threads that read through an EpochDomain, and takes
+        // them back when the threads exit. Threads past the limit get -1.
+        class ThreadNumber {
+        public:
+            ThreadNumber() : number(-1) {
+                std::lock_guard<std::mutex> guard(lock());
+                for (int i = 0; i < MAX_THREADS; ++i) {
+                    if (!taken()[i]) {
+                        taken()[i] = true;
+                        number = i;
+                        break;
+                    }
+                }
+            }
+
+            ~ThreadNumber() {
+                if (number >= 0) {
+                    std::lock_guard<std::mutex> guard(lock());
+                    taken()[number] = false;
+                }
+            }
+
+            static int current() {
+                thread_local ThreadNumber self;
+                return self.number;
+            }
+
+        private:
+            static std::mutex &lock() {
+                static std::mutex m;
+                return m;
+            }
+
+            static bool *taken() {
+                static bool numbers[MAX_THREADS] = {};
+                return numbers;
+            }
+
+            int number;
+        }; // CS : ThreadNumber
+    } // NS : epoch_detail
+
+    /*
+     * EpochDomain lets readers walk a structure without locks while a writer unlinks parts of it: the writer
+     * hands what it unlinked to retire() instead of deleting it, and reclaim() deletes it once every reader
+     * that might still have seen it is gone.
+     *
+     *     { EpochDomain::ReadGuard guard(domain); ... read ... }    // any number of threads
+     *     publish the new version; domain.retire(oldNode); domain.reclaim();  // one writer at a time
+     *
+     * A reader announces the epoch it started in. Objects retired in epoch e can go once every reader that is
+     * still inside a guard announced an epoch after e, because those readers started after the writer had
+     * published, and so cannot have seen them. A reader stuck inside a guard holds back reclamation, not writers.
+     *
+     * Each reading thread needs one of MAX_THREADS slots while it lives. Threads past that still read safely,
+     * but while any of them is inside a guard nothing is reclaimed.
+     */
+    class EpochDomain {
+    public:
+        static const int MAX_THREADS = epoch_detail::MAX_THREADS;
+
+        EpochDomain() : epoch(1), overflowReaders(0) {
+            for (auto &slot : slots) {
+                slot.epoch.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        EpochDomain(const EpochDomain &) = delete;
+        EpochDomain &operator=(const EpochDomain &) = delete;
+
+        // Readers must all be gone by now.
+        ~EpochDomain() {
+            for (auto &object : retired) {
+                object.destroy(object.pointer);
+            }
+        }
+
+        // Marks the calling thread as reading for as long as the guard lives. Guards can nest.
+        class ReadGuard {
+        public:
+            explicit ReadGuard(EpochDomain &d) : domain(d), slot(epoch_detail::ThreadNumber::current()), owner(true) {
+                if (slot < 0) {
+                    domain.overflowReaders.fetch_add(1);
+                    return;
+                }
+                std::atomic<uint64_t> &announced = domain.slots[slot].epoch;
+                if (announced.load(std::memory_order_relaxed)) {
+                    owner = false;  // An outer guard on this thread already covers us.
+                    return;
+                }
+                // Sequentially consistent, so that either the writer sees this announcement when it looks, or
+                // this thread sees everything the writer published before it looked.
+                announced.store(domain.epoch.load());
+            }
+
+            ~ReadGuard() {
+                if (!owner) {
+                    return;
+                }
+                if (slot < 0) {
+                    domain.overflowReaders.fetch_sub(1, std::memory_order_release);
+                } else {
+                    domain.slots[slot].epoch.store(0, std::memory_order_release);
+                }
+            }
+
+            ReadGuard(const ReadGuard &) = delete;
+            ReadGuard &operator=(const ReadGuard &) = delete;
+
+        private:
+            EpochDomain &domain;
+            int slot;
+            bool owner;
+        }; // CS : ReadGuard
+
+        // The writer calls these, one thread at a time, after it has published the version that no longer
+        // reaches object.
+        template <typename T>
+        void retire(T *object) {
+            retired.push_back(Retired{object, &destroy<T>, epoch.load(std::memory_order_relaxed)});
+        }
+
+        // Deletes whatever no reader can still see, and returns how many objects that was.
+        size_t reclaim() {
+            uint64_t current = epoch.fetch_add(1);  // Readers from now on announce a later epoch.
+            if (overflowReaders.load()) {
+                return 0;
+            }
+            uint64_t oldest = current + 1;
+            for (auto &slot : slots) {
+                uint64_t announced = slot.epoch.load();
+                if (announced && (announced < oldest)) {
+                    oldest = announced;
+                }
+            }
+            size_t freed = 0;
+            while (!retired.empty() && (retired.front().epoch < oldest)) {
+                retired.front().destroy(retired.front().pointer);
+                retired.pop_front();
+                ++freed;
+            }
+            return freed;
+        }
+
+        size_t pending() const {return retired.size();}
+
+    private:
+        struct Retired {
+            void *pointer;
+            void (*destroy)(void *);
+            uint64_t epoch;
+        };
+
+        struct alignas(64) Slot { // One cache line each, so that readers do not slow each other down.
+            std::atomic<uint64_t> epoch; // 0 while the thread is not reading.
+        };
+
+        template <typename T>
+        static void destroy(void *object) {delete static_cast<T *>(object);}
+
+        std::atomic<uint64_t> epoch;
+        std::atomic<int> overflowReaders;
+        Slot slots[MAX_THREADS];
+        std::deque<Retired> retired; // In the order retired, so epochs never decrease along it.
+    }; // CS : EpochDomain
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_EPOCH_H
@@ -0,0 +1,204 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_FLAT_SEARCH_TREE_H
+#define APFN_DATA_STRUCTURES_FLAT_SEARCH_TREE_H
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uintptr_t
+#include <vector>   // The slots.
+#include <utility>  // std::move, std::swap
+
+#include "tree_traversal.h"
+
+namespace vvalgo {
+
+    namespace eytzinger_detail {
+        const size_t LINE = 64;
+        const size_t AHEAD = 16; // Slots four levels down.
+
+        // Asks for the lines holding slots[k] to slots[k + 15], which may be past the end: the address is only
+        // a hint and is never read, so it is worked out as an integer.
+        template <typename ValueType>
+        void prefetch(const ValueType *slots, size_t k) {
+#ifdef __GNUC__
+            uintptr_t first = reinterpret_cast<uintptr_t>(slots) + k * sizeof(ValueType);
+            for (size_t offset = 0; offset < AHEAD * sizeof(ValueType); offset += LINE) {
+                __builtin_prefetch(reinterpret_cast<const void *>(first + offset));
+            }
+#else
+            (void)slots;
+            (void)k;
+#endif
+        }
+
+        // The slot, among slots[1] to slots[count] in Eytzinger order, of the smallest value not less than val,
+        // or 0. The descent ends below a leaf; the slots where it went right are the 1 bits at the bottom of k,
+        // and the answer is where it last went left.
+        template <typename ValueType>
+        size_t lowerBound(const ValueType *slots, size_t count, const ValueType &val) {
+            size_t k = 1;
+            while (k <= count) {
+                prefetch(slots, AHEAD * k);
+                k = 2 * k + (slots[k] < val);
+            }
+#ifdef __GNUC__
+            k >>= __builtin_ffsll(static_cast<long long>(~k));
+#else
+            while (k & 1) {
+                k >>= 1;
+            }
+            k >>= 1;
+#endif
+            return k;
+        }
+    } // NS : eytzinger_detail
+
+    /*
+     * FlatSearchTree is a read-only copy of a search tree's values in one array, in Eytzinger order: the root in
+     * slot 1 and the children of slot k in slots 2k and 2k + 1, like a binary heap. Made from a tree that will
+     * not change for a while, it answers the same lookups without chasing a single pointer.
+     *
+     * The top levels of every search share the first few cache lines, which stay cached. Further down, the
+     * 16 possible slots four levels below k are side by side at 16k, so find() asks for their cache lines
+     * while it works through the four levels in between, and by the time it gets there they have mostly
+     * arrived. The step down is k = 2k + (slots[k] < val), with no branch to mispredict, and the array is
+     * aligned so that those 16 slots share as few lines as possible.
+     *
+     * The values come from an in-order walk of the source tree (anything tree_traversal.h can walk: RBTree,
+     * BST nodes, BinaryTree if it is ordered), and the source is not needed afterwards.
+     */
+    template <typename ValueType>
+    class FlatSearchTree {
+    public:
+        FlatSearchTree() : count(0), slots(nullptr) {}
+
+        template <typename Node>
+        explicit FlatSearchTree(Node *root) : count(0), slots(nullptr) {
+            for (auto &node : inorder(root)) {
+                (void)node;
+                ++count;
+            }
+            allocate();
+            // Walk the implicit tree's slots in in-order alongside the source tree: start at the leftmost slot,
+            // then go to the leftmost slot of the right subtree, or else up past every right child we came from.
+            size_t k = leftmost(1);
+            for (auto &node : inorder(root)) {
+                slots[k] = node.value;
+                if (2 * k + 1 <= count) {
+                    k = leftmost(2 * k + 1);
+                } else {
+                    while (k & 1) {
+                        k >>= 1;
+                    }
+                    k >>= 1;
+                }
+            }
+        }
+
+        FlatSearchTree(const FlatSearchTree &other) : count(other.count), slots(nullptr) {
+            allocate();
+            for (size_t k = 1; k <= count; ++k) {
+                slots[k] = other.slots[k];
+            }
+        }
+
+        // Moving a vector keeps its buffer, so slots still points into it.
+        FlatSearchTree(FlatSearchTree &&other) : count(other.count), storage(std::move(other.storage)), slots(other.slots) {
+            other.count = 0;
+            other.slots = nullptr;
+        }
+
+        FlatSearchTree &operator=(FlatSearchTree other) {
+            std::swap(count, other.count);
+            storage.swap(other.storage);
+            std::swap(slots, other.slots);
+            return *this;
+        }
+
+        size_t size() const {return count;}
+        bool isEmpty() const {return !count;}
+
+        // The smallest value not less than val, or null if there is none.
+        const ValueType *lowerBound(const ValueType &val) const {
+            size_t k = eytzinger_detail::lowerBound(slots, count, val);
+            return k ? &slots[k] : nullptr;
+        }
+
+        // The value equal to val, or null.
+        const ValueType *find(const ValueType &val) const {
+            size_t k = eytzinger_detail::lowerBound(slots, count, val);
+            return (k && !(val < slots[k])) ? &slots[k] : nullptr;
+        }
+
+        bool contains(const ValueType &val) const {return find(val) != nullptr;}
+
+        // The array itself: slotArray()[1] to slotArray()[size()] in Eytzinger order, after an unused
+        // slotArray()[0].
+        const ValueType *slotArray() const {return slots;}
+
+        // Checks that an in-order walk of the slots is sorted. Meant for tests: it visits every slot.
+        bool isValid() const {
+            const ValueType *previous = nullptr;
+            size_t k = count ? leftmost(1) : 0;
+            for (size_t seen = 0; seen < count; ++seen) {
+                if (previous && (slots[k] < *previous)) {
+                    return false;
+                }
+                previous = &slots[k];
+                if (2 * k + 1 <= count) {
+                    k = leftmost(2 * k + 1);
+                } else {
+                    while (k & 1) {
+                        k >>= 1;
+                    }
+                    k >>= 1;
+                }
+            }
+            return true;
+        }
+
+    private:
+        // Room for slots 0 to count, with slot 0 (never used) placed so that 16k starts a cache line where
+        // the value size allows.
+        void allocate() {
+            const size_t LINE = eytzinger_detail::LINE;
+            storage.assign(count + 1 + LINE / sizeof(ValueType) + 1, ValueType());
+            size_t skip = 0;
+            if (!(LINE % sizeof(ValueType))) {
+                uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+                skip = ((LINE - address % LINE) % LINE) / sizeof(ValueType);
+            }
+            slots = storage.data() + skip;
+        }
+
+        size_t leftmost(size_t k) const {
+            while (2 * k <= count) {
+                k *= 2;
+            }
+            return k;
+        }
+
+        size_t count;
+        std::vector<ValueType> storage;
+        ValueType *slots;   // slots[1] to slots[count], inside storage.
+    }; // CS : FlatSearchTree
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_FLAT_SEARCH_TREE_H
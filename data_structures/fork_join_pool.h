@@ -0,0 +1,206 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_FORK_JOIN_POOL_H
+#define APFN_DATA_STRUCTURES_FORK_JOIN_POOL_H
+
+#include <atomic>               // std::atomic for task completion.
+#include <vector>               // Workers and injected root tasks.
+#include <memory>               // std::unique_ptr
+#include <thread>               // std::thread, std::this_thread::yield
+#include <mutex>                // std::mutex, std::unique_lock
+#include <condition_variable>   // Parking idle workers and waking the thread that called run().
+#include <random>               // std::minstd_rand for picking victims.
+
+#include "work_stealing_deque.h"
+
+namespace vvalgo {
+
+/*
+ * ForkJoinPool runs recursive divide and conquer computations on a fixed set of worker threads, each owning
+ * a WorkStealingDeque of tasks.
+ *
+ *     ForkJoinPool pool(8);
+ *     pool.run([&]() { sum = parallelSum(pool, b, e); });
+ *
+ * where parallelSum() splits its range and calls pool.invoke(leftHalf, rightHalf). invoke() pushes the
+ * second function onto the calling worker's deque, runs the first one itself, and then either pops the
+ * second one back (nobody needed the work) or, if an idle worker stole it, helps with other tasks until the
+ * thief is done. So invoke() returns only once both functions have run, and the stack frames that the two
+ * functions refer to stay alive for as long as they are needed. Tasks therefore never allocate.
+ *
+ * Idle workers sleep while no run() is in progress.
+ */
+class ForkJoinPool {
+public:
+    explicit ForkJoinPool(int threads) : stopping(false), activeRoots(0) {
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back(new Worker);
+        }
+        for (int i = 0; i < threads; ++i) {
+            workers[i]->thread = std::thread([this, i]() {workerLoop(i);});
+        }
+    }
+    
+    ForkJoinPool(const ForkJoinPool &) = delete;
+    ForkJoinPool &operator=(const ForkJoinPool &) = delete;
+    
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) {
+            worker->thread.join();
+        }
+    }
+    
+    int threadCount() const {return static_cast<int>(workers.size());}
+    
+    // Runs f on one of the workers and returns once it has finished. f may call invoke() as deeply as it
+    // wants. Calling run() from inside the pool simply calls f.
+    template <typename F>
+    void run(F &&f) {
+        if (current().pool == this) {
+            f();
+            return;
+        }
+        FunctionTask<F> task(f);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            injected.push_back(&task);
+            ++activeRoots;
+        }
+        wake.notify_all();
+        std::unique_lock<std::mutex> guard(lock);
+        rootDone.wait(guard, [&task]() {return task.done.load(std::memory_order_acquire);});
+    }
+    
+    // Runs f1 and f2, possibly in parallel, and returns once both are done.
+    template <typename F1, typename F2>
+    void invoke(F1 &&f1, F2 &&f2) {
+        Context context = current();
+        if (context.pool != this) {
+            run([&]() {invoke(f1, f2);});
+            return;
+        }
+        Worker &worker = *workers[context.index];
+        FunctionTask<F2> second(f2);
+        worker.deque.push(&second);
+        f1();
+        while (!second.done.load(std::memory_order_acquire)) {
+            Task *task = nullptr;
+            if (worker.deque.pop(task) || stealFromOthers(context.index, task)) {
+                task->execute(); // Usually 'second' itself. Otherwise we help whoever stole it.
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+    
+private:
+    struct Task {
+        std::atomic<bool> done;
+        Task() : done(false) {}
+        virtual ~Task() {}
+        virtual void run() = 0;
+        void execute() {
+            run();
+            done.store(true, std::memory_order_release);
+        }
+    };
+    
+    template <typename F>
+    struct FunctionTask : Task {
+        F &f; // The function object lives in the frame that waits for this task.
+        FunctionTask(F &f) : f(f) {}
+        void run() {f();}
+    };
+    
+    struct Worker {
+        WorkStealingDeque<Task *> deque;
+        std::thread thread;
+    };
+    
+    struct Context { // Which pool and worker the calling thread belongs to, if any.
+        ForkJoinPool *pool;
+        int index;
+    };
+    
+    static Context &current() {
+        thread_local Context context = {nullptr, -1};
+        return context;
+    }
+    
+    bool stealFromOthers(int self, Task *&task) {
+        thread_local std::minstd_rand generator(static_cast<unsigned>(self + 1));
+        int n = threadCount();
+        int start = static_cast<int>(generator() % n);
+        for (int k = 0; k < n; ++k) {
+            int victim = (start + k) % n;
+            if ( (victim != self) && workers[victim]->deque.steal(task) ) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void workerLoop(int index) {
+        current() = Context{this, index};
+        Worker &worker = *workers[index];
+        while (true) {
+            Task *task = nullptr;
+            if (worker.deque.pop(task) || stealFromOthers(index, task)) {
+                task->execute();
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(lock);
+            if (stopping) {
+                return;
+            }
+            if (!injected.empty()) {
+                task = injected.back();
+                injected.pop_back();
+                guard.unlock();
+                task->execute();
+                guard.lock();
+                --activeRoots;
+                guard.unlock();
+                rootDone.notify_all();
+            } else if (activeRoots == 0) {
+                wake.wait(guard, [this]() {return stopping || !injected.empty() || (activeRoots > 0);});
+            } else { // Some computation is running. Keep looking for work to steal.
+                guard.unlock();
+                std::this_thread::yield();
+            }
+        }
+    }
+    
+    std::vector<std::unique_ptr<Worker> > workers;
+    std::mutex lock;                    // Protects everything below.
+    std::condition_variable wake;       // Idle workers park here while activeRoots == 0.
+    std::condition_variable rootDone;   // Threads waiting in run() park here.
+    std::vector<Task *> injected;       // Root tasks from run() that no worker has picked up yet.
+    bool stopping;
+    int activeRoots;
+};
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_FORK_JOIN_POOL_H
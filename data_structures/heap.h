@@ -21,9 +21,155 @@
 
 #include <vector>       // std::vector for internal storage that grows in amortised linear time.
 #include <functional>   // std::less (the default ordering predicate)
-#include <algorithm>    // std::swap
+#include <algorithm>    // std::swap, std::reverse, std::find
+#include <iterator>     // std::iterator_traits
 
 namespace vvalgo {
+
+    namespace heap { // Iterator based heap algorithms. They only rearrange elements within [b, e) and never copy or
+                     // allocate, so they work on any caller owned random access range (including memory mapped arrays).
+                     // The orderPredicate defines the heap: orderPredicate(*parent, *child) should hold for every pair.
+
+        template <typename T>
+        T leftChild(T b, T e, T parent) { // Have to use names like b and e since begin and end conflict with template functions
+            if ( (b == e) || (parent == e) ) {
+                return e;
+            }
+            
+            unsigned long long n = e - b;
+            unsigned long long pIndex = parent - b;
+            // 0 -> 1, 2
+            // 1 -> 3, 4
+            // 2 -> 5, 6
+            // 3 -> 7, 8
+            unsigned long long lChildIndex = pIndex * 2 + 1;
+            if (lChildIndex >= n) {
+                return e;
+            } else {
+                return b + lChildIndex;
+            }
+        }
+        
+        template <typename T>
+        T rightChild(T b, T e, T parent) {
+            auto lChild = leftChild(b, e, parent);
+            if ( (lChild != e) && ((lChild + 1) != e) ) {
+                return lChild + 1;
+            } else {
+                return e;
+            }
+        }
+        
+        template <typename T>
+        T parent(T b, T e, T child) {
+            // 0 -> 1, 2
+            // 1 -> 3, 4
+            // 2 -> 5, 6
+            // 3 -> 7, 8
+            // l -> 2p+1, r = 2a+2 , this means that left child always has an odd index while the right
+            //                       child has the immediately next even index.
+            // so, p = (l-1)/2 and (r-2)/2
+            // so we can just find the closest even number and conver it to rchild index
+            unsigned long long childIndex = child - b;
+            // this formula does fail when childIndex is 0, so provide a short-circuit for that
+            if (childIndex == 0) {
+                return e; // The head/root of the hap has no parent.
+            }
+            unsigned long long rChildIndex = childIndex + (childIndex%2);
+            unsigned long long parentIndex = (rChildIndex - 2) / 2;
+            return b + parentIndex;
+        }
+        
+        // Sifts *element down until both its children are ordered after it. Written as a loop rather than
+        // tail recursion so that we do not depend on the optimizer for the stack depth on huge ranges.
+        template <typename T, typename OrderPredicate>
+        void heapifyDown(T b, T e, T element, OrderPredicate orderPredicate) {
+            while (true) {
+                auto lChild = leftChild(b, e, element);
+                if (lChild == e) { // No children, so element is a leaf.
+                    return;
+                }
+                auto rChild = rightChild(b, e, element);
+                
+                // Find the smaller of the chldren in order to decide if the parent satisfies the min heap condition.
+                auto minChild = lChild;
+                if ( (rChild != e) && orderPredicate(*rChild, *lChild) ) {
+                    minChild = rChild;
+                }
+                
+                if (!orderPredicate(*minChild, *element)) { // The parent is already ordered before its children.
+                    return;
+                }
+                std::swap(*element, *minChild);
+                element = minChild;
+            }
+        }
+        
+        template <typename T, typename OrderPredicate>
+        void heapifyUp(T b, T e, T element, OrderPredicate orderPredicate) {
+            while (element != b) { // Heapification is complete once we reach the head/root.
+                auto l_parent = parent(b, e, element);
+                if (!orderPredicate(*element, *l_parent)) { // The ordering between parent and child satisfies the heap orderPredicate
+                    return;
+                }
+                std::swap(*l_parent, *element);
+                element = l_parent;
+            }
+        }
+        
+        template <typename T, typename OrderPredicate>
+        void buildHeap(T b, T e, OrderPredicate orderPredicate) {
+            if ( (b == e) || ((b + 1) == e) ) {
+                return; // An array with 0 or 1 element is already a heap.
+            }
+            
+            // Since the heap is an almost complete binary tree, the right half contains all leaves.
+            // e.x., leftChild(n/2) --> n+1
+            // But, leftChild(n/2 - 1) --> 2(n/2-1)+1 --> n - 1
+            long long n = e - b;
+            for (long long i = n / 2 - 1; i >= 0; --i) {
+                heapifyDown(b, e, b+i, orderPredicate);
+            }
+        }
+        
+        // [b, e - 1) is a heap and *(e - 1) is a new element. Moves the new element to its place.
+        template <typename T, typename OrderPredicate>
+        void pushHeap(T b, T e, OrderPredicate orderPredicate) {
+            if (b == e) {
+                return;
+            }
+            heapifyUp(b, e, e - 1, orderPredicate);
+        }
+        
+        /*
+         * Similar to STL algorithms, we take care to just modify the arrangement of the
+         * elements in the array rather than delete any of them. As such, iterators suffice as input.
+         * Returns the new location of the head, which is always e - 1 for a non-empty range.
+         */
+        template <typename T, typename OrderPredicate>
+        T extractHead(T b, T e, OrderPredicate orderPredicate) {
+            if ( (b == e) || ((b + 1) == e) ) {
+                return b;
+            }
+            
+            long long N = e - b;
+            std::swap(*b, *(b+N-1));
+            heapifyDown(b, b + N - 1, b, orderPredicate);
+            return b + N - 1;
+        }
+        
+        // We are calling this sortHeap because we are going to sort with the assumption that
+        // the range is already a heap (heapified possibly by calling buildHeap()). Like the text-book
+        // version, the head ends up at the back, so a min-heap is sorted in descending order.
+        template <typename T, typename OrderPredicate>
+        void sortHeap(T b, T e, OrderPredicate orderPredicate) {
+            for (T currentEnd = e; currentEnd != b; --currentEnd) {
+                extractHead(b, currentEnd, orderPredicate);
+            }
+        }
+        
+    } // NS : heap
+
     /*
      A Heap is an in-place Priority Queue. It is defined by the following properties:
      1. A transitive ordering between the parent and its children. In a min-heap, the min function defines the order
@@ -31,7 +177,8 @@ namespace vvalgo {
      creator of the instance. We want it to be parametrized. We also want to assume a default ordering function.
      2. We will use our own internal storage for the heap instead of mrely providing functions
      that a caller can use on his/her own storage. This is for the sake of simplification as well
-     as for providing a more powerful and well rounded heap data structure.
+     as for providing a more powerful and well rounded heap data structure. Callers who do want to work
+     on their own storage can use the algorithms in vvalgo::heap or a HeapView.
      */
     
     template <typename T, typename ValueType = typename T::value_type, typename OrderPredicate = std::function<bool (ValueType, ValueType) > >
@@ -45,7 +192,7 @@ namespace vvalgo {
 
         // Constructors :
         Heap(OrderPredicate op = std::less<ValueType>()):orderPredicate(op){}
-        Heap(T b, T e, OrderPredicate op = std::less<ValueType>()):orderPredicate(op),storage(b, e) {buildHeap(storage.begin(), storage.end());}
+        Heap(T b, T e, OrderPredicate op = std::less<ValueType>()):storage(b, e),orderPredicate(op) {heap::buildHeap(storage.begin(), storage.end(), orderPredicate);}
         
         // Iterators :
         // We only return const iterators because allowing the user to modify
@@ -79,7 +226,7 @@ namespace vvalgo {
         // Inserts a new element into the heap.
         void insert(ValueType element) {
             storage.push_back(element);
-            heapifyUp(storage.begin(), storage.end(), storage.begin() + (storage.size() - 1) );
+            heap::pushHeap(storage.begin(), storage.end(), orderPredicate);
         }
         
         // Removes the element from the heap.
@@ -91,12 +238,17 @@ namespace vvalgo {
                 return;
             }
             auto lastElement = (storage.begin() + (storage.size() - 1));
+            if (element == lastElement) { // Nothing moves into the vacated slot.
+                storage.erase(lastElement);
+                return;
+            }
             std::swap(*element, *lastElement);
             storage.erase(lastElement);
-            if (orderPredicate(*parent(storage.begin(), storage.end(), element), *element)) {
-                heapifyDown(storage.begin(), storage.end(), element);
+            auto l_parent = heap::parent(storage.begin(), storage.end(), element);
+            if ( (l_parent == storage.end()) || orderPredicate(*l_parent, *element) ) {
+                heap::heapifyDown(storage.begin(), storage.end(), element, orderPredicate);
             } else {
-                heapifyUp(storage.begin(), storage.end(), element);
+                heap::heapifyUp(storage.begin(), storage.end(), element, orderPredicate);
             }
         }
         
@@ -128,140 +280,92 @@ namespace vvalgo {
         size_t size() {return storage.size();}
         // Unlike the text-book heapsorts, I'm going to reverse the entries after we have finished the
         // usual heap sort. This will ensure that the heap still obeys the heap properties after being sorted.
-        void sort() {sortHeap(storage.begin(), storage.end());reverse(storage.begin(), storage.end());}
+        void sort() {heap::sortHeap(storage.begin(), storage.end(), orderPredicate);std::reverse(storage.begin(), storage.end());}
         
-    private: // I'm using begin and end iterators in all these private methods so that if need be, these can be
-             // exported to the outside world for it to use them with their containers.
-        Iterator leftChild(Iterator b, Iterator e, Iterator parent) { // Have to use names like b and e since begin and end conflict with template functions
-            if ( (b == e) || (parent == e) ) {
-                return e;
-            }
-            
-            unsigned long long n = e - b;
-            unsigned long long pIndex = parent - b;
-            // 0 -> 1, 2
-            // 1 -> 3, 4
-            // 2 -> 5, 6
-            // 3 -> 7, 8
-            unsigned long long lChildIndex = pIndex * 2 + 1;
-            if (lChildIndex >= n) {
-                return e;
-            } else {
-                return b + lChildIndex;
+    private:
+        void removeHead() {
+            auto headsNewLocation = heap::extractHead(storage.begin(), storage.end(), orderPredicate);
+            if (headsNewLocation != storage.end()) {
+                storage.erase(headsNewLocation);
             }
         }
         
-        Iterator rightChild(Iterator b, Iterator e, Iterator parent) { // Have to use names like b and e since begin and end conflict with template functions
-            auto lChild = leftChild(b, e, parent);
-            if (lChild != e) {
-                return lChild + 1;
-            } else {
-                return lChild;
-            }
-        }
+    }; // CS : Heap
+    
+    /*
+     * A HeapView is a priority queue that lives inside storage owned by the caller. It never copies
+     * or allocates; it only remembers where the live heap ends within [b, capacityEnd).
+     * The caller must keep the storage alive (and unmoved) for as long as the view is in use.
+     *
+     * Elements in [b, e) are heapified on construction. Popped elements are not destroyed, they are
+     * parked right after the live heap the same way std::pop_heap does it.
+     */
+    template <typename T, typename OrderPredicate = std::less<typename std::iterator_traits<T>::value_type> >
+    class HeapView {
+    public:
+        typedef typename std::iterator_traits<T>::value_type ValueType;
         
-        Iterator parent(Iterator b, Iterator e, Iterator child) {
-            // 0 -> 1, 2
-            // 1 -> 3, 4
-            // 2 -> 5, 6
-            // 3 -> 7, 8
-            // l -> 2p+1, r = 2a+2 , this means that left child always has an odd index while the right
-            //                       child has the immediately next even index.
-            // so, p = (l-1)/2 and (r-2)/2
-            // so we can just find the closest even number and conver it to rchild index
-            unsigned long long childIndex = child - b;
-            unsigned long long rChildIndex = childIndex + (childIndex%2);
-            unsigned long long parentIndex = (rChildIndex - 2) / 2;
-            // this formula does fail when childIndex is 0, so provide a short-circuit for that
-            if (childIndex == 0) {
-                return e; // The head/root of the hap has no parent.
-            }
-            return b + parentIndex;
+        // Constructors :
+        // A view over exactly [b, e). insert() will fail since there is no spare capacity.
+        HeapView(T b, T e, OrderPredicate op = OrderPredicate()) : b(b), e(e), capacityEnd(e), orderPredicate(op) {
+            heap::buildHeap(b, e, orderPredicate);
         }
-        
-        void heapifyDown(Iterator b, Iterator e, Iterator parent) {
-            auto lChild = leftChild(b, e, parent);
-            auto rChild = rightChild(b, e, parent);
-            
-            if (rChild == lChild) { // can only happen if both are equal to e
-                return;
-            }
-            
-            // Find the smaller of the chldren in order to decide if the parent satisfies the min heap condition.
-            // At this point, we are sure that at least left child is valid.
-            auto minChild = lChild;
-            if (rChild != e) { // If the right child exists as well, it may possibly be the smaller of the two children.
-                minChild = orderPredicate(*lChild, *rChild) ? lChild : rChild;
-            }
-            
-            if (!orderPredicate(*parent, *minChild)) { // If the minimum child is smaller than the parent
-                // Swap the parent and smaller child
-                std::swap(*parent, *minChild);
-                //heapifyDown(b, e, minChild); // Tail-recursion (so can be optimized away by the compiler tools.
-            }
-            heapifyDown(b, e, minChild); // Tail-recursion (so can be optimized away by the compiler tools.
+        // A view whose live heap is [b, e), but which may grow up to capacityEnd.
+        HeapView(T b, T e, T capacityEnd, OrderPredicate op = OrderPredicate()) : b(b), e(e), capacityEnd(capacityEnd), orderPredicate(op) {
+            heap::buildHeap(b, e, orderPredicate);
         }
         
-        void heapifyUp(Iterator b, Iterator e, Iterator element) {
-            if (element == b) { // If we are trying to heapify up the head/root.
-                return; // Heapification has successfully completed.
-            }
-            auto l_parent = parent(b, e, element); // I am considering using come standard coding guidelines after having to use l_parent for my local variable.
-            if (!orderPredicate(*l_parent, *element)) { // If the ordering between parent and child satisfies the heap orderPredicate
-                std::swap(*l_parent, *element);
-                //return; // heapification has been successfully completed and we need not proceed further up.
-            }
-            
-            heapifyUp(b, e, l_parent); // Tail-recursion (so can be optimized away by the compiler tools.
-        }
+        // Iterators over the live heap.
+        T begin() const {return b;}
+        T end() const {return e;}
         
-        void buildHeap(Iterator b, Iterator e) {
-            if ( (b == e) || ((b + 1) == e) ) {
-                return; // An array with 0 or 1 element is already a heap.
-            }
-            
-            // Since the heap is an almost complete binary tree, the right half contains all leaves.
-            // e.x., leftChild(n/2) --> n+1
-            // But, leftChild(n/2 - 1) --> 2(n/2-1)+1 --> n - 1
-            long n = e - b;
-            for (long i = n / 2 - 1; i >= 0; --i) {
-                heapifyDown(b, e, b+i);
+        // Basics :
+        bool isEmpty() const {return b == e;}
+        bool isFull() const {return e == capacityEnd;}
+        size_t size() const {return e - b;}
+        size_t capacity() const {return capacityEnd - b;}
+        bool peekHead(ValueType &head) const {
+            if (isEmpty()) {
+                return false;
             }
+            head = *b;
+            return true;
         }
         
-        /*
-         * Similar to STL algorithms, we take care to just modify the arrangement of the
-         * elements in the array rather than delete any of them. As such, iterators suffice as input.
-         */
-        Iterator extractHead(Iterator b, Iterator e) {
-            if ( (b == e) || ((b + 1) == e) ) {
-                return b;
+        // Updation :
+        // Returns false if the heap was empty.
+        bool popHead() {
+            if (isEmpty()) {
+                return false;
             }
-            
-            long long N = e - b;
-            std::swap(*b, *(b+N-1));
-            heapifyDown(b, b + N - 1, b);
-            return b + N - 1;
+            e = heap::extractHead(b, e, orderPredicate);
+            return true;
         }
         
-        void removeHead() {
-            auto headsNewLocation = extractHead(storage.begin(), storage.end());
-            if (headsNewLocation != storage.end()) {
-                storage.erase(headsNewLocation);
+        // Returns false if there is no room left in the caller's storage.
+        bool insert(const ValueType &element) {
+            if (isFull()) {
+                return false;
             }
+            *e = element;
+            ++e;
+            heap::pushHeap(b, e, orderPredicate);
+            return true;
         }
-
-        void sortHeap(Iterator b, Iterator e) { // We are calling this sortHeap because we are going to sort with the assumption that
-            // the container is already a heap (heapified possibly by calling buildHeap().
-            long long N = e - b;
-            
-            for (long long i = 0; i < N; ++i) {
-                auto currentEnd = b + N - i;
-                extractHead(b, currentEnd);
-            }
+        
+        // Same post condition as Heap::sort(): the elements end up in ascending order of orderPredicate,
+        // which is still a valid heap.
+        void sort() {
+            heap::sortHeap(b, e, orderPredicate);
+            std::reverse(b, e);
         }
         
-    }; // CS : Heap
+    private:
+        T b;
+        T e;
+        T capacityEnd;
+        OrderPredicate orderPredicate;
+    }; // CS : HeapView
     
 } // NS : vvalgo
 
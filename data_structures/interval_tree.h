@@ -0,0 +1,163 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_INTERVAL_TREE_H
+#define APFN_DATA_STRUCTURES_INTERVAL_TREE_H
+
+#include <initializer_list> // Both children in one loop.
+
+#include "stack.h"
+#include "binary_search_tree.h"
+
+namespace vvalgo {
+
+    // The closed interval [low, high]. Intervals sort by low end, then by high end.
+    template <typename T>
+    struct Interval {
+        T low;
+        T high;
+
+        bool overlaps(const T &l, const T &h) const {return !(h < low) && !(high < l);}
+
+        bool operator<(const Interval &other) const {
+            return (low < other.low) || (!(other.low < low) && (high < other.high));
+        }
+        bool operator==(const Interval &other) const {return (low == other.low) && (high == other.high);}
+    };
+
+    /*
+     * A red-black tree node holding an interval, which also keeps the highest high end in its subtree.
+     * BST and RB keep that up to date through inserts, removes and rotations by way of recomputeAugmentation(),
+     * and IT uses it to skip every subtree that ends before the query starts. Like any RB tree it is a set: the
+     * same interval inserted twice is stored once.
+     */
+    template <typename T>
+    class IntervalTree {
+    public:
+        Interval<T> value;
+        bool red;
+        T maxHigh;      // Highest high end in this subtree, this node included.
+        IntervalTree *left;
+        IntervalTree *right;
+        IntervalTree *parent;
+
+        // Same as RBTree: nodes live on the heap and a node deletes its subtree.
+        IntervalTree(Interval<T> val, IntervalTree *l = nullptr, IntervalTree *r = nullptr, IntervalTree *p = nullptr)
+            : value(val), red(false), maxHigh(val.high), left(l), right(r), parent(p) {
+            recomputeAugmentation();
+        }
+
+        ~IntervalTree() {
+            deleteSubtree(left);
+            deleteSubtree(right);
+        }
+
+        bool isRed() const {return red;}
+        void setRed(bool r) {red = r;}
+
+        void recomputeAugmentation() {
+            maxHigh = value.high;
+            if (left && (maxHigh < left->maxHigh)) {
+                maxHigh = left->maxHigh;
+            }
+            if (right && (maxHigh < right->maxHigh)) {
+                maxHigh = right->maxHigh;
+            }
+        }
+    }; // CS : IntervalTree
+
+    /*
+     * Overlap queries for any tree ordered by low end whose nodes keep maxHigh up to date. A subtree is skipped
+     * when its maxHigh is below the query's low end, and everything right of a node whose low end is past the
+     * query's high end is skipped too. Every node visited is then an interval that overlaps, or on the path
+     * to one, so reporting k intervals costs O(log n + k) when they sit together in the tree and never more than
+     * O(k log n) on a balanced one; a scan of the whole tree is O(n) whatever k is.
+     */
+    namespace IT {
+        // Returns some node whose interval overlaps [low, high], or null if none does, in O(height).
+        template <typename NodePtr, typename T>
+        NodePtr anyOverlapping(NodePtr root, const T &low, const T &high) {
+            while (root && !root->value.overlaps(low, high)) {
+                // If the left subtree reaches low at all, one of its intervals starts no later than the one that
+                // reaches it and so overlaps; or else nothing to the right does either. (CLRS, Interval-Search.)
+                root = (root->left && !(root->left->maxHigh < low)) ? root->left : root->right;
+            }
+            return root;
+        }
+
+        // Calls visit(node), in no particular order, for every node whose interval overlaps [low, high], until
+        // visit returns true.
+        template <typename NodePtr, typename T, typename Visit>
+        void overlapping(NodePtr root, const T &low, const T &high, Visit visit) {
+            Stack<NodePtr, 64> pending;
+            if (root) {
+                pending.push(root);
+            }
+            NodePtr node;
+            while (pending.pop(node)) {
+                if (node->maxHigh < low) {
+                    continue;               // Everything here ends before the query starts.
+                }
+                if (node->left) {
+                    pending.push(node->left);
+                }
+                if (high < node->value.low) {
+                    continue;               // This one and everything right of it starts after the query ends.
+                }
+                if (!(node->value.high < low) && visit(node)) {
+                    return;
+                }
+                if (node->right) {
+                    pending.push(node->right);
+                }
+            }
+        }
+
+        // Every node whose interval contains point.
+        template <typename NodePtr, typename T, typename Visit>
+        void containing(NodePtr root, const T &point, Visit visit) {
+            overlapping(root, point, point, visit);
+        }
+
+        // Checks every maxHigh against the node's children. Meant for tests: it visits the whole tree.
+        template <typename NodePtr>
+        bool isValid(NodePtr root) {
+            Stack<NodePtr, 64> pending;
+            if (root) {
+                pending.push(root);
+            }
+            NodePtr node;
+            while (pending.pop(node)) {
+                auto expected = node->value.high;
+                for (NodePtr child : {node->left, node->right}) {
+                    if (child) {
+                        expected = (expected < child->maxHigh) ? child->maxHigh : expected;
+                        pending.push(child);
+                    }
+                }
+                if (!(expected == node->maxHigh) || (node->value.high < node->value.low)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // NS : IT
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_INTERVAL_TREE_H
@@ -0,0 +1,209 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_MIN_MAX_HEAP_H
+#define APFN_DATA_STRUCTURES_MIN_MAX_HEAP_H
+
+#include <vector>       // std::vector for internal storage that grows in amortised linear time.
+#include <functional>   // std::less (the default ordering predicate)
+#include <algorithm>    // std::swap
+
+#include "heap.h"       // vvalgo::heap index arithmetic.
+
+namespace vvalgo {
+    
+    /*
+     * A MinMaxHeap is an in-place double ended priority queue (Atkinson, Sack, Santoro and Strothotte).
+     * It uses the same almost complete binary tree layout as Heap, but the levels alternate:
+     * - a node on an even level (the root is on level 0) is ordered before everything in its subtree,
+     * - a node on an odd level is ordered after everything in its subtree.
+     * So the min is the root and the max is one of the root's children. Both can be read in O(1) and
+     * popped in O(log n). "min" and "max" are with respect to orderPredicate.
+     */
+    template <typename ValueType, typename OrderPredicate = std::less<ValueType> >
+    class MinMaxHeap {
+    private:
+        std::vector<ValueType> storage;
+        OrderPredicate orderPredicate;
+        
+    public:
+        typedef decltype(storage.begin()) Iterator;
+        
+        // Constructors :
+        MinMaxHeap(OrderPredicate op = OrderPredicate()) : orderPredicate(op) {}
+        
+        // Iterators : const only, for the same reason as Heap.
+        auto begin() -> decltype (storage.cbegin()) const {return storage.cbegin();}
+        auto end() -> decltype (storage.cend()) const {return storage.cend();}
+        
+        // Basics :
+        bool isEmpty() const {return storage.empty();}
+        size_t size() const {return storage.size();}
+        
+        bool peekMin(ValueType &min) const {
+            if (isEmpty()) {
+                return false;
+            }
+            min = storage[0];
+            return true;
+        }
+        
+        bool peekMax(ValueType &max) {
+            if (isEmpty()) {
+                return false;
+            }
+            max = *maxElement();
+            return true;
+        }
+        
+        // Updation :
+        void insert(const ValueType &element) {
+            storage.push_back(element);
+            Iterator b = storage.begin(), e = storage.end();
+            Iterator element_ = e - 1;
+            Iterator l_parent = heap::parent(b, e, element_);
+            if (l_parent == e) { // The new element is the root.
+                return;
+            }
+            if (isMinLevel(b, element_)) {
+                if (orderPredicate(*l_parent, *element_)) { // Belongs on the max levels above us.
+                    std::swap(*l_parent, *element_);
+                    pushUp(b, e, l_parent, false);
+                } else {
+                    pushUp(b, e, element_, true);
+                }
+            } else {
+                if (orderPredicate(*element_, *l_parent)) { // Belongs on the min levels above us.
+                    std::swap(*l_parent, *element_);
+                    pushUp(b, e, l_parent, true);
+                } else {
+                    pushUp(b, e, element_, false);
+                }
+            }
+        }
+        
+        void popMin() {
+            if (!isEmpty()) {
+                removeAt(storage.begin());
+            }
+        }
+        
+        void popMax() {
+            if (!isEmpty()) {
+                removeAt(maxElement());
+            }
+        }
+        
+    private:
+        // Level of the root is 0. Even levels are min levels.
+        static bool isMinLevel(Iterator b, Iterator element) {
+            unsigned long long n = (element - b) + 1;
+            int level = 0;
+            while (n > 1) {
+                n >>= 1;
+                ++level;
+            }
+            return (level % 2) == 0;
+        }
+        
+        // On min levels an element must come before its descendants, on max levels after them.
+        bool before(const ValueType &a, const ValueType &b, bool minLevel) {
+            return minLevel ? orderPredicate(a, b) : orderPredicate(b, a);
+        }
+        
+        Iterator maxElement() {
+            Iterator b = storage.begin(), e = storage.end();
+            Iterator l = heap::leftChild(b, e, b);
+            if (l == e) {
+                return b;
+            }
+            Iterator r = heap::rightChild(b, e, b);
+            return ( (r != e) && orderPredicate(*l, *r) ) ? r : l;
+        }
+        
+        Iterator grandparent(Iterator b, Iterator e, Iterator element) {
+            Iterator l_parent = heap::parent(b, e, element);
+            return (l_parent == e) ? e : heap::parent(b, e, l_parent);
+        }
+        
+        // Moves element up through the grandparents that share its kind of level.
+        void pushUp(Iterator b, Iterator e, Iterator element, bool minLevel) {
+            Iterator g = grandparent(b, e, element);
+            while ( (g != e) && before(*element, *g, minLevel) ) {
+                std::swap(*element, *g);
+                element = g;
+                g = grandparent(b, e, element);
+            }
+        }
+        
+        // Restores the order below element, which sits on a level of the kind given by minLevel.
+        void trickleDown(Iterator b, Iterator e, Iterator element, bool minLevel) {
+            while (true) {
+                Iterator children[2] = {heap::leftChild(b, e, element), heap::rightChild(b, e, element)};
+                if (children[0] == e) {
+                    return;
+                }
+                // Find the best (in the sense of this level) among the children and grandchildren.
+                Iterator best = children[0];
+                bool bestIsGrandchild = false;
+                for (Iterator child : children) {
+                    if (child == e) {
+                        continue;
+                    }
+                    if (before(*child, *best, minLevel)) {
+                        best = child;
+                        bestIsGrandchild = false;
+                    }
+                    Iterator grandchildren[2] = {heap::leftChild(b, e, child), heap::rightChild(b, e, child)};
+                    for (Iterator grandchild : grandchildren) {
+                        if ( (grandchild != e) && before(*grandchild, *best, minLevel) ) {
+                            best = grandchild;
+                            bestIsGrandchild = true;
+                        }
+                    }
+                }
+                if (!before(*best, *element, minLevel)) {
+                    return;
+                }
+                std::swap(*best, *element);
+                if (!bestIsGrandchild) { // A child has no descendants of our kind below it to worry about.
+                    return;
+                }
+                Iterator l_parent = heap::parent(b, e, best);
+                if (before(*l_parent, *best, minLevel)) { // The element we moved down must also respect the level in between.
+                    std::swap(*l_parent, *best);
+                }
+                element = best;
+            }
+        }
+        
+        void removeAt(Iterator element) {
+            Iterator lastElement = storage.begin() + (storage.size() - 1);
+            bool minLevel = isMinLevel(storage.begin(), element);
+            std::swap(*element, *lastElement);
+            storage.pop_back();
+            if (element != storage.end()) {
+                trickleDown(storage.begin(), storage.end(), element, minLevel);
+            }
+        }
+        
+    }; // CS : MinMaxHeap
+    
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_MIN_MAX_HEAP_H
@@ -0,0 +1,163 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_NODE_POOL_H
+#define APFN_DATA_STRUCTURES_NODE_POOL_H
+
+#include <cstddef>      // size_t
+#include <new>          // placement new
+#include <utility>      // std::forward, std::declval
+#include <type_traits>  // std::aligned_storage, std::is_trivially_destructible
+
+#include "tree_traversal.h"
+
+namespace vvalgo {
+
+/*
+ * NodePool hands out tree nodes (BinaryTree, RBTree, or anything else TreeLinks knows about) from slabs of
+ * SlabNodes nodes each, instead of one heap allocation per node. Destroyed nodes go on a free list that the
+ * next create() reuses, so a tree that keeps changing does not allocate at all once it has reached its size,
+ * and neighbouring nodes tend to share cache lines and pages.
+ *
+ *     NodePool<BinaryTree<int> > pool;
+ *     BinaryTree<int> *root = pool.create(100);
+ *     root->lChild = pool.create(50);
+ *     ...
+ *     pool.destroyTree(root);   // or pool.releaseAll() to drop every node in one go
+ *
+ * Nodes from a pool must go back to the same pool and never to delete. destroy() clears a node's child
+ * links before running its destructor, so the destructor never goes after the children. The pool does not
+ * know which of its nodes are still alive, so anything left in it when it goes away is released without its
+ * destructor being run. That is fine for trivially destructible values and a leak otherwise.
+ */
+template <typename Node, size_t SlabNodes = 4096>
+class NodePool {
+public:
+	typedef typename std::remove_reference<decltype(std::declval<Node &>().value)>::type ValueType;
+
+	NodePool() : slabs(nullptr), spareSlabs(nullptr), unusedInSlab(0), freeList(nullptr), live(0), slabCount(0) {}
+
+	NodePool(const NodePool &) = delete;
+	NodePool &operator=(const NodePool &) = delete;
+
+	~NodePool() {
+		freeSlabs(slabs);
+		freeSlabs(spareSlabs);
+	}
+
+	template <typename... Args>
+	Node *create(Args&&... args) {
+		void *memory;
+		if (freeList) {
+			memory = freeList;
+			freeList = freeList->next;
+		} else {
+			if (!unusedInSlab) {
+				grow();
+			}
+			memory = &slabs->nodes[SlabNodes - unusedInSlab];
+			--unusedInSlab;
+		}
+		++live;
+		return new (memory) Node(std::forward<Args>(args)...);
+	}
+
+	// Destroys this one node. Its children, if any, are left alone.
+	void destroy(Node *node) {
+		tree_detail::left(node) = nullptr;
+		tree_detail::right(node) = nullptr;
+		node->~Node();
+		freeList = new (node) FreeSlot{freeList};
+		--live;
+	}
+
+	// Destroys a whole tree, children before parents, without recursion.
+	void destroyTree(Node *root) {
+		for (auto it = postorder(root).begin(); it != PostorderIterator<Node>(); ) {
+			Node *node = &*it;
+			++it; // Done with the node before it goes away.
+			destroy(node);
+		}
+	}
+
+	/*
+	 * Releases every node handed out by this pool at once, without visiting any of them. This is O(number
+	 * of slabs) rather than O(number of nodes), and only allowed when there are no destructors to run.
+	 * The slabs are kept for the nodes created afterwards.
+	 */
+	void releaseAll() {
+		static_assert(std::is_trivially_destructible<ValueType>::value,
+		              "Values need their destructors run. Use destroyTree() instead.");
+		while (slabs) {
+			Slab *next = slabs->next;
+			slabs->next = spareSlabs;
+			spareSlabs = slabs;
+			slabs = next;
+		}
+		unusedInSlab = 0;
+		freeList = nullptr;
+		live = 0;
+	}
+
+	size_t size() const {return live;}                             // Nodes currently handed out.
+	size_t slabsAllocated() const {return slabCount;}              // Heap allocations made so far.
+	size_t reservedBytes() const {return slabCount * sizeof(Slab);}
+
+private:
+	struct FreeSlot {
+		FreeSlot *next;
+	};
+	static_assert(sizeof(Node) >= sizeof(FreeSlot), "A free node must be able to hold the free list link.");
+
+	struct Slab {
+		Slab *next;
+		typename std::aligned_storage<sizeof(Node), alignof(Node)>::type nodes[SlabNodes];
+	};
+
+	void grow() {
+		Slab *slab = spareSlabs;
+		if (slab) {
+			spareSlabs = slab->next;
+		} else {
+			slab = new Slab;
+			++slabCount;
+		}
+		slab->next = slabs;
+		slabs = slab;
+		unusedInSlab = SlabNodes;
+	}
+
+	static void freeSlabs(Slab *slab) {
+		while (slab) {
+			Slab *next = slab->next;
+			delete slab;
+			slab = next;
+		}
+	}
+
+	Slab *slabs;            // The slab at the front is the one being carved up.
+	Slab *spareSlabs;       // Emptied by releaseAll() and waiting to be reused.
+	size_t unusedInSlab;    // Never handed out nodes at the end of the front slab.
+	FreeSlot *freeList;
+	size_t live;
+	size_t slabCount;
+}; // CS : NodePool
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_NODE_POOL_H
@@ -0,0 +1,142 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_ORDER_STATISTIC_TREE_H
+#define APFN_DATA_STRUCTURES_ORDER_STATISTIC_TREE_H
+
+#include <cstddef>  // size_t
+
+#include "stack.h"
+#include "binary_search_tree.h"
+
+namespace vvalgo {
+
+    /*
+     * A red-black tree node that also counts the nodes in its subtree. BST::insert()/remove() and
+     * RB::insert()/remove() keep the counts right through recomputeAugmentation(), which is what lets
+     * OS::select() and OS::rank() find their way down in O(height) instead of visiting the whole tree.
+     */
+    template <typename ValueType>
+    class OrderStatisticTree {
+    public:
+        ValueType value;
+        bool red;
+        size_t size;    // Nodes in this subtree, this one included.
+        OrderStatisticTree *left;
+        OrderStatisticTree *right;
+        OrderStatisticTree *parent;
+
+        // Same as RBTree: nodes live on the heap and a node deletes its subtree.
+        OrderStatisticTree(ValueType val, OrderStatisticTree *l = nullptr, OrderStatisticTree *r = nullptr,
+                           OrderStatisticTree *p = nullptr)
+            : value(val), red(false), size(1), left(l), right(r), parent(p) {
+            recomputeAugmentation();
+        }
+
+        ~OrderStatisticTree() {
+            deleteSubtree(left);
+            deleteSubtree(right);
+        }
+
+        bool isRed() const {return red;}
+        void setRed(bool r) {red = r;}
+
+        void recomputeAugmentation() {size = 1 + (left ? left->size : 0) + (right ? right->size : 0);}
+    }; // CS : OrderStatisticTree
+
+    /*
+     * Order statistics for any tree whose nodes keep a size member up to date, balanced or not. Ranks count
+     * from 0, like selectKthSmallest() in misc/random_select.h: the smallest value has rank 0.
+     */
+    namespace OS {
+        template <typename NodePtr>
+        size_t size(NodePtr node) {return node ? node->size : 0;}
+
+        // Returns the node holding the kth smallest value, or null if the tree holds k values or fewer.
+        template <typename NodePtr>
+        NodePtr select(NodePtr root, size_t k) {
+            while (root) {
+                size_t smaller = size(root->left);
+                if (k == smaller) {
+                    break;
+                }
+                if (k < smaller) {
+                    root = root->left;
+                } else {
+                    k -= smaller + 1;
+                    root = root->right;
+                }
+            }
+            return root;
+        }
+
+        // Number of values in the tree less than val. That is the rank of val if it is there (of the first of
+        // them, if val is there more than once) and the rank it would get if it was inserted otherwise.
+        template <typename NodePtr, typename ValueType>
+        size_t rank(NodePtr root, const ValueType &val) {
+            size_t smaller = 0;
+            while (root) {
+                if (root->value < val) {
+                    smaller += size(root->left) + 1;
+                    root = root->right;
+                } else {
+                    root = root->left;
+                }
+            }
+            return smaller;
+        }
+
+        // Rank of the value in node, from the sizes of the subtrees to its left on the way up.
+        template <typename NodePtr>
+        size_t rankOf(NodePtr node) {
+            size_t smaller = size(node->left);
+            for (NodePtr parent = node->parent; parent; node = parent, parent = parent->parent) {
+                if (node == parent->right) {
+                    smaller += size(parent->left) + 1;
+                }
+            }
+            return smaller;
+        }
+
+        // Checks every size against the children's. Meant for tests: it visits the whole tree.
+        template <typename NodePtr>
+        bool isValid(NodePtr root) {
+            Stack<NodePtr, 64> pending;
+            if (root) {
+                pending.push(root);
+            }
+            NodePtr node;
+            while (pending.pop(node)) {
+                if (node->size != 1 + size(node->left) + size(node->right)) {
+                    return false;
+                }
+                if (node->left) {
+                    pending.push(node->left);
+                }
+                if (node->right) {
+                    pending.push(node->right);
+                }
+            }
+            return true;
+        }
+
+    } // NS : OS
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_ORDER_STATISTIC_TREE_H
@@ -0,0 +1,200 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_PAIRING_HEAP_H
+#define APFN_DATA_STRUCTURES_PAIRING_HEAP_H
+
+#include <vector>       // scratch space for the two pass pairing in popHead().
+#include <functional>   // std::less (the default ordering predicate)
+#include <utility>      // std::swap
+
+namespace vvalgo {
+    
+    /*
+     * A PairingHeap is a heap ordered multiway tree. Every node keeps its first child and its next sibling, so
+     * the whole heap is a root with a list of subtrees.
+     * - insert() and meld() link two roots: the one ordered later becomes the first child of the other. O(1).
+     * - decreaseKey() cuts the node's subtree out and links it with the root. O(1) here, o(log n) amortised.
+     * - popHead() removes the root and pairs up its children left to right, then melds the pairs right to left.
+     *   O(log n) amortised.
+     *
+     * insert() returns a Handle to the element which stays valid until that element is popped, including
+     * across meld(). It is what decreaseKey() expects.
+     */
+    template <typename ValueType, typename OrderPredicate = std::less<ValueType> >
+    class PairingHeap {
+    private:
+        struct Node {
+            ValueType value;
+            Node *child;    // First child.
+            Node *sibling;  // Next sibling.
+            Node *prev;     // Previous sibling, or the parent for a first child. nullptr for the root.
+            Node(const ValueType &value) : value(value), child(nullptr), sibling(nullptr), prev(nullptr) {}
+        };
+        
+    public:
+        typedef Node *Handle;
+        
+        PairingHeap(OrderPredicate op = OrderPredicate()) : root(nullptr), count(0), orderPredicate(op) {}
+        ~PairingHeap() {clear();}
+        
+        // Copying would silently invalidate every handle, so we do not allow it.
+        PairingHeap(const PairingHeap &) = delete;
+        PairingHeap &operator=(const PairingHeap &) = delete;
+        
+        // Basics :
+        bool isEmpty() const {return root == nullptr;}
+        size_t size() const {return count;}
+        
+        // Returns true if the heap has at least one element. Copies the head element into the passed reference.
+        bool peekHead(ValueType &head) const {
+            if (isEmpty()) {
+                return false;
+            }
+            head = root->value;
+            return true;
+        }
+        
+        // Updation :
+        Handle insert(const ValueType &element) {
+            Node *node = new Node(element);
+            root = link(root, node);
+            ++count;
+            return node;
+        }
+        
+        // Removes the head element from the heap.
+        void popHead() {
+            if (isEmpty()) {
+                return;
+            }
+            Node *oldRoot = root;
+            root = combineSiblings(root->child);
+            delete oldRoot;
+            --count;
+        }
+        
+        // Moves every element of 'other' into this heap. Handles into 'other' become handles into this heap.
+        void meld(PairingHeap &other) {
+            if (this == &other) {
+                return;
+            }
+            root = link(root, other.root);
+            count += other.count;
+            other.root = nullptr;
+            other.count = 0;
+        }
+        
+        // Replaces the element behind 'handle' by 'updatedVal', which must not be ordered after the current value.
+        // Returns false (and changes nothing) if it is.
+        bool decreaseKey(Handle handle, const ValueType &updatedVal) {
+            if (orderPredicate(handle->value, updatedVal)) {
+                return false;
+            }
+            handle->value = updatedVal;
+            if (handle == root) {
+                return true;
+            }
+            // Cut the subtree rooted at handle out of its sibling list...
+            if (handle->prev->child == handle) {
+                handle->prev->child = handle->sibling;
+            } else {
+                handle->prev->sibling = handle->sibling;
+            }
+            if (handle->sibling) {
+                handle->sibling->prev = handle->prev;
+            }
+            handle->sibling = handle->prev = nullptr;
+            // ...and link it with the root.
+            root = link(root, handle);
+            return true;
+        }
+        
+        void clear() { // Iterative so that long sibling lists cannot overflow the stack.
+            std::vector<Node *> pending;
+            if (root) {
+                pending.push_back(root);
+            }
+            while (!pending.empty()) {
+                Node *node = pending.back();
+                pending.pop_back();
+                if (node->child) {
+                    pending.push_back(node->child);
+                }
+                if (node->sibling) {
+                    pending.push_back(node->sibling);
+                }
+                delete node;
+            }
+            root = nullptr;
+            count = 0;
+        }
+        
+    private:
+        // Links two roots (either may be nullptr) and returns the new root.
+        Node *link(Node *a, Node *b) {
+            if (!a) {
+                return b;
+            }
+            if (!b) {
+                return a;
+            }
+            if (orderPredicate(b->value, a->value)) {
+                std::swap(a, b);
+            }
+            // b becomes the first child of a.
+            b->prev = a;
+            b->sibling = a->child;
+            if (a->child) {
+                a->child->prev = b;
+            }
+            a->child = b;
+            a->sibling = a->prev = nullptr;
+            return a;
+        }
+        
+        // The two pass pairing. Returns the root of the combined heap.
+        Node *combineSiblings(Node *first) {
+            std::vector<Node *> &pairs = scratch;
+            pairs.clear();
+            while (first) { // First pass: link adjacent pairs, left to right.
+                Node *a = first;
+                Node *b = first->sibling;
+                first = b ? b->sibling : nullptr;
+                a->sibling = a->prev = nullptr;
+                if (b) {
+                    b->sibling = b->prev = nullptr;
+                }
+                pairs.push_back(link(a, b));
+            }
+            Node *combined = nullptr;
+            for (auto i = pairs.rbegin(); i != pairs.rend(); ++i) { // Second pass: meld right to left.
+                combined = link(*i, combined);
+            }
+            return combined;
+        }
+        
+        Node *root;
+        size_t count;
+        OrderPredicate orderPredicate;
+        std::vector<Node *> scratch; // Reused by combineSiblings() so that popHead() does not allocate.
+    }; // CS : PairingHeap
+    
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_PAIRING_HEAP_H
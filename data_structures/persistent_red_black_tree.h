@@ -0,0 +1,394 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_PERSISTENT_RED_BLACK_TREE_H
+#define APFN_DATA_STRUCTURES_PERSISTENT_RED_BLACK_TREE_H
+
+#include <cstddef>      // size_t, std::ptrdiff_t
+#include <iterator>     // std::forward_iterator_tag
+#include <memory>       // std::shared_ptr
+
+#include "stack.h"
+
+namespace vvalgo {
+
+    /*
+     * Red-black trees whose nodes never change once built. An update copies the path from the root down to
+     * where it changes the tree, rebalancing the copies on the way (Okasaki's insertion, Kahrs' deletion), and
+     * returns a new root. Everything off that path is shared with the old tree, which stays as it was, so each
+     * update allocates O(log n) nodes.
+     *
+     * The functions work with any NodeRef that the Builder knows how to make, as long as nodes have key,
+     * value, red, left and right members:
+     *
+     *     NodeRef make(const Key &key, const Value &value);                    // a red leaf
+     *     NodeRef make(bool red, NodeRef left, const NodeRef &entry, NodeRef right); // entry's key and value
+     *     void consume(const NodeRef &node);  // node has been copied, and the new tree does not use it
+     *
+     * consume() is for builders that free old nodes themselves (see ConcurrentOrderedMap). With reference
+     * counting there is nothing to do there.
+     */
+    namespace FRB {
+        template <typename Node>
+        const Node *get(const Node *node) {return node;}
+
+        template <typename Node>
+        const Node *get(const std::shared_ptr<const Node> &node) {return node.get();}
+
+        template <typename NodeRef>
+        bool isRed(const NodeRef &node) {return node && node->red;}
+
+        template <typename NodeRef>
+        bool isBlack(const NodeRef &node) {return node && !node->red;}
+
+        template <typename Node, typename Key>
+        const Node *lookup(const Node *node, const Key &key) {
+            while (node) {
+                if (key < node->key) {
+                    node = get(node->left);
+                } else if (node->key < key) {
+                    node = get(node->right);
+                } else {
+                    break;
+                }
+            }
+            return node;
+        }
+
+        // Checks the red-black invariants and the key order, and counts the nodes. Recursion depth is the
+        // height of the tree, which these invariants keep logarithmic.
+        template <typename Node>
+        bool isValid(const Node *root, size_t &count) {
+            struct Check {
+                static bool below(const Node *node, const Node *low, const Node *high, size_t blacks,
+                                  size_t &blackHeight, size_t &count) {
+                    if (!node) {
+                        if (!blackHeight) {
+                            blackHeight = blacks + 1;
+                        }
+                        return blackHeight == blacks + 1;
+                    }
+                    ++count;
+                    if ( (low && !(low->key < node->key)) || (high && !(node->key < high->key)) ||
+                         (node->red && (isRed(node->left) || isRed(node->right))) ) {
+                        return false;
+                    }
+                    blacks += node->red ? 0 : 1;
+                    return below(get(node->left), low, node, blacks, blackHeight, count) &&
+                           below(get(node->right), node, high, blacks, blackHeight, count);
+                }
+            };
+            size_t blackHeight = 0;
+            count = 0;
+            return !isRed(root) && Check::below(root, nullptr, nullptr, 0, blackHeight, count);
+        }
+
+        template <typename Builder>
+        class PathCopy {
+        public:
+            typedef typename Builder::NodeRef NodeRef;
+
+            explicit PathCopy(Builder &b) : builder(b) {}
+
+            // key must not be in the tree yet.
+            template <typename Key, typename Value>
+            NodeRef insert(const NodeRef &root, const Key &key, const Value &value) {
+                return blacken(insertBelow(root, key, value));
+            }
+
+            // key must be in the tree.
+            template <typename Key>
+            NodeRef remove(const NodeRef &root, const Key &key) {
+                return blacken(removeBelow(root, key));
+            }
+
+        private:
+            NodeRef make(bool red, const NodeRef &left, const NodeRef &entry, const NodeRef &right) {
+                return builder.make(red, left, entry, right);
+            }
+
+            NodeRef recolor(const NodeRef &node, bool red) {
+                builder.consume(node);
+                return make(red, node->left, node, node->right);
+            }
+
+            NodeRef blacken(const NodeRef &node) {return isRed(node) ? recolor(node, false) : node;}
+
+            // Balances a black node with children a and b that may have a red-red pair below them. The result
+            // is a red node with two black children when it restructures, and a black node otherwise.
+            NodeRef balance(const NodeRef &a, const NodeRef &entry, const NodeRef &b) {
+                if (isRed(a) && isRed(b)) {
+                    builder.consume(a);
+                    builder.consume(b);
+                    return make(true, make(false, a->left, a, a->right), entry, make(false, b->left, b, b->right));
+                }
+                if (isRed(a) && isRed(a->left)) {
+                    NodeRef aa = a->left;
+                    builder.consume(a);
+                    builder.consume(aa);
+                    return make(true, make(false, aa->left, aa, aa->right), a, make(false, a->right, entry, b));
+                }
+                if (isRed(a) && isRed(a->right)) {
+                    NodeRef ab = a->right;
+                    builder.consume(a);
+                    builder.consume(ab);
+                    return make(true, make(false, a->left, a, ab->left), ab, make(false, ab->right, entry, b));
+                }
+                if (isRed(b) && isRed(b->right)) {
+                    NodeRef bb = b->right;
+                    builder.consume(b);
+                    builder.consume(bb);
+                    return make(true, make(false, a, entry, b->left), b, make(false, bb->left, bb, bb->right));
+                }
+                if (isRed(b) && isRed(b->left)) {
+                    NodeRef ba = b->left;
+                    builder.consume(b);
+                    builder.consume(ba);
+                    return make(true, make(false, a, entry, ba->left), ba, make(false, ba->right, b, b->right));
+                }
+                return make(false, a, entry, b);
+            }
+
+            template <typename Key, typename Value>
+            NodeRef insertBelow(const NodeRef &node, const Key &key, const Value &value) {
+                if (!node) {
+                    return builder.make(key, value);
+                }
+                builder.consume(node);
+                if (key < node->key) {
+                    NodeRef left = insertBelow(node->left, key, value);
+                    return node->red ? make(true, left, node, node->right) : balance(left, node, node->right);
+                }
+                NodeRef right = insertBelow(node->right, key, value);
+                return node->red ? make(true, node->left, node, right) : balance(node->left, node, right);
+            }
+
+            // Deletion. left has one black less on all its paths than right, after a deletion below it.
+            NodeRef balanceLeft(const NodeRef &left, const NodeRef &entry, const NodeRef &right) {
+                if (isRed(left)) {
+                    return make(true, recolor(left, false), entry, right);
+                }
+                if (isBlack(right)) {
+                    return balance(left, entry, recolor(right, true));
+                }
+                NodeRef middle = right->left; // right is red, so this is black.
+                builder.consume(right);
+                builder.consume(middle);
+                return make(true, make(false, left, entry, middle->left), middle,
+                            balance(middle->right, right, recolor(right->right, true)));
+            }
+
+            NodeRef balanceRight(const NodeRef &left, const NodeRef &entry, const NodeRef &right) {
+                if (isRed(right)) {
+                    return make(true, left, entry, recolor(right, false));
+                }
+                if (isBlack(left)) {
+                    return balance(recolor(left, true), entry, right);
+                }
+                NodeRef middle = left->right;
+                builder.consume(left);
+                builder.consume(middle);
+                return make(true, balance(recolor(left->left, true), left, middle->left), middle,
+                            make(false, middle->right, entry, right));
+            }
+
+            // Joins two subtrees of the same black height, all of a's keys before all of b's.
+            NodeRef append(const NodeRef &a, const NodeRef &b) {
+                if (!a) {
+                    return b;
+                }
+                if (!b) {
+                    return a;
+                }
+                if (a->red != b->red) {
+                    if (b->red) {
+                        builder.consume(b);
+                        return make(true, append(a, b->left), b, b->right);
+                    }
+                    builder.consume(a);
+                    return make(true, a->left, a, append(a->right, b));
+                }
+                builder.consume(a);
+                builder.consume(b);
+                NodeRef middle = append(a->right, b->left);
+                if (isRed(middle)) {
+                    builder.consume(middle);
+                    return make(true, make(a->red, a->left, a, middle->left), middle,
+                                make(a->red, middle->right, b, b->right));
+                }
+                if (a->red) {
+                    return make(true, a->left, a, make(true, middle, b, b->right));
+                }
+                return balanceLeft(a->left, a, make(false, middle, b, b->right));
+            }
+
+            template <typename Key>
+            NodeRef removeBelow(const NodeRef &node, const Key &key) {
+                builder.consume(node);
+                if (key < node->key) {
+                    NodeRef left = removeBelow(node->left, key);
+                    return isBlack(node->left) ? balanceLeft(left, node, node->right)
+                                               : make(true, left, node, node->right);
+                }
+                if (node->key < key) {
+                    NodeRef right = removeBelow(node->right, key);
+                    return isBlack(node->right) ? balanceRight(node->left, node, right)
+                                                : make(true, node->left, node, right);
+                }
+                return append(node->left, node->right);
+            }
+
+            Builder &builder;
+        }; // CS : PathCopy
+    } // NS : FRB
+
+    /*
+     * PersistentRBTree is an ordered map with O(1) snapshots: copying one is just copying its root pointer.
+     * Updates path-copy (see FRB above), so they never disturb a snapshot, and nodes are reference counted,
+     * so a node goes away with the last version that uses it. Different threads may freely use different
+     * versions, for instance scan a snapshot while another thread keeps updating the original. A single version
+     * is no more thread-safe than any other object.
+     *
+     * Keys are unique: insert() leaves an existing key alone and returns false.
+     */
+    template <typename Key, typename Value>
+    class PersistentRBTree {
+    private:
+        struct Node;
+        typedef std::shared_ptr<const Node> NodeRef;
+
+        struct Node {
+            Key key;
+            Value value;
+            bool red;
+            NodeRef left;
+            NodeRef right;
+            Node(const Key &k, const Value &v, bool r, const NodeRef &l, const NodeRef &rt)
+                : key(k), value(v), red(r), left(l), right(rt) {}
+        };
+
+        struct Builder {
+            typedef PersistentRBTree::NodeRef NodeRef;
+            NodeRef make(const Key &key, const Value &value) {
+                return std::make_shared<const Node>(key, value, true, nullptr, nullptr);
+            }
+            NodeRef make(bool red, const NodeRef &left, const NodeRef &entry, const NodeRef &right) {
+                return std::make_shared<const Node>(entry->key, entry->value, red, left, right);
+            }
+            void consume(const NodeRef &) {}
+        };
+
+    public:
+        // In-order iterator over one version. The version has to outlive it.
+        class ConstIterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Node value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Node *pointer;
+            typedef const Node &reference;
+
+            ConstIterator() {}
+
+            const Key &key() const {return path.top()->key;}
+            const Value &value() const {return path.top()->value;}
+
+            ConstIterator &operator++() {
+                const Node *node = path.top();
+                path.pop();
+                pushLeftSpine(node->right.get());
+                return *this;
+            }
+
+            ConstIterator operator++(int) {
+                ConstIterator previous(*this);
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(const ConstIterator &other) const {return current() == other.current();}
+            bool operator!=(const ConstIterator &other) const {return current() != other.current();}
+
+        private:
+            friend class PersistentRBTree;
+            explicit ConstIterator(const Node *root) {pushLeftSpine(root);}
+
+            void pushLeftSpine(const Node *node) {
+                for (; node; node = node->left.get()) {
+                    path.push(node);
+                }
+            }
+
+            const Node *current() const {return path.is_empty() ? nullptr : path.top();}
+
+            Stack<const Node *, 64> path; // Red-black trees are never deeper than this with 2^32 nodes.
+        }; // CS : ConstIterator
+
+        PersistentRBTree() : entries(0) {}
+
+        // Copies share every node, so they cost O(1). A copy is a snapshot.
+        PersistentRBTree snapshot() const {return *this;}
+
+        // Stays valid for as long as some version holding this entry is alive.
+        const Value *find(const Key &key) const {
+            const Node *node = FRB::lookup(root.get(), key);
+            return node ? &node->value : nullptr;
+        }
+
+        bool insert(const Key &key, const Value &value) {
+            if (FRB::lookup(root.get(), key)) {
+                return false;
+            }
+            Builder builder;
+            root = FRB::PathCopy<Builder>(builder).insert(root, key, value);
+            ++entries;
+            return true;
+        }
+
+        bool remove(const Key &key) {
+            if (!FRB::lookup(root.get(), key)) {
+                return false;
+            }
+            Builder builder;
+            root = FRB::PathCopy<Builder>(builder).remove(root, key);
+            --entries;
+            return true;
+        }
+
+        ConstIterator begin() const {return ConstIterator(root.get());}
+        ConstIterator end() const {return ConstIterator();}
+
+        size_t size() const {return entries;}
+        bool isEmpty() const {return entries == 0;}
+
+        // True if both versions are the same tree, not just equal contents.
+        bool sharesRootWith(const PersistentRBTree &other) const {return root == other.root;}
+
+        bool isValid() const {
+            size_t count;
+            return FRB::isValid(root.get(), count) && (count == entries);
+        }
+
+    private:
+        NodeRef root;
+        size_t entries;
+    }; // CS : PersistentRBTree
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_PERSISTENT_RED_BLACK_TREE_H
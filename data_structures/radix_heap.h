@@ -0,0 +1,170 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_RADIX_HEAP_H
+#define APFN_DATA_STRUCTURES_RADIX_HEAP_H
+
+#include <vector>       // std::vector for the buckets.
+#include <limits>       // std::numeric_limits for the bucket count.
+
+namespace vvalgo {
+    
+    // Default key extractor for RadixHeap. The value itself is the key.
+    struct IdentityKey {
+        template <typename ValueType>
+        unsigned long long operator()(const ValueType &value) const {return static_cast<unsigned long long>(value);}
+    };
+    
+    /*
+     * A RadixHeap is a min priority queue for unsigned integer keys that is allowed to assume that the keys
+     * are monotone: no key smaller than the last popped head is ever inserted. That is exactly the situation in
+     * Dijkstra's shortest paths and in discrete event simulation.
+     *
+     * We remember 'last', the key of the most recently extracted head. An element with key k lives in bucket
+     * 0 if k == last, and otherwise in bucket i where i - 1 is the highest bit in which k differs from last.
+     * Because k >= last, every key in bucket i is smaller than every key in bucket i + 1. When bucket 0 runs dry
+     * we take the first non-empty bucket, make its smallest key the new 'last' and redistribute its elements.
+     * They all land in strictly lower buckets, so every element moves at most once per bit of the key.
+     * That gives O(1) insert and O(log C) amortised popHead, without comparing elements against each other.
+     *
+     * 'last' can run ahead of the popped keys: peekHead() refills bucket 0 too, and the first inserts into an
+     * empty heap set it. Only the key of the last popped head limits inserts, though. A key below 'last' but
+     * not below that one is smaller than everything in the heap, so it becomes 'last' itself, and only the
+     * buckets up to its highest differing bit have to be redistributed (see rebase()).
+     *
+     * Values carry an arbitrary payload. KeyExtractor maps a value to its unsigned key.
+     */
+    template <typename ValueType, typename KeyExtractor = IdentityKey>
+    class RadixHeap {
+    public:
+        RadixHeap(KeyExtractor ke = KeyExtractor()) : buckets(BUCKETS), last(0), lastPopped(0), count(0), keyOf(ke) {}
+        
+        // Basics :
+        bool isEmpty() const {return count == 0;}
+        size_t size() const {return count;}
+        
+        // Returns true if the heap has at least one element. Copies the head element into the passed reference.
+        bool peekHead(ValueType &head) {
+            if (!refillBucketZero()) {
+                return false;
+            }
+            head = buckets[0].back();
+            return true;
+        }
+        
+        // Updation :
+        // Removes the head element from the heap.
+        void popHead() {
+            if (refillBucketZero()) {
+                buckets[0].pop_back();
+                --count;
+                lastPopped = count ? last : 0; // An empty heap accepts any key again.
+            }
+        }
+        
+        // Inserts a new element. Returns false (and leaves the heap untouched) if the key is smaller than the
+        // key of the last extracted head, since that would break the monotone assumption. Peeking does not
+        // count as extracting, and an empty heap accepts any key.
+        bool insert(const ValueType &element) {
+            unsigned long long key = keyOf(element);
+            if (key < lastPopped) {
+                return false;
+            }
+            if (count == 0) {
+                last = key;
+            } else if (key < last) {
+                rebase(key);
+            }
+            buckets[bucketFor(key)].push_back(element);
+            ++count;
+            return true;
+        }
+        
+    private:
+        static const int BUCKETS = std::numeric_limits<unsigned long long>::digits + 1;
+        
+        int bucketFor(unsigned long long key) const {
+            unsigned long long difference = key ^ last;
+            int bucket = 0;
+            while (difference) { // Position of the highest differing bit, plus one. At most 64 iterations,
+                ++bucket;        // and usually only a handful since keys stay close to 'last'.
+                difference >>= 1;
+            }
+            return bucket;
+        }
+        
+        /*
+         * Makes key, which is smaller than every key in the heap, the new 'last'. With h the highest bit in which
+         * key differs from 'last', a key in a bucket above h + 1 differs from both in the same highest bit, so it
+         * stays put. Everything in buckets 0 to h agrees with 'last' down to bit h, so it differs from key first
+         * at bit h and moves up to bucket h + 1. Bucket h + 1 itself agrees with key down to bit h, so it is
+         * redistributed into lower buckets.
+         */
+        void rebase(unsigned long long key) {
+            int top = bucketFor(key);
+            std::vector<ValueType> redistribute;
+            redistribute.swap(buckets[top]);
+            last = key;
+            for (int i = 0; i < top; ++i) {
+                buckets[top].insert(buckets[top].end(), buckets[i].begin(), buckets[i].end());
+                buckets[i].clear();
+            }
+            for (const auto &element : redistribute) {
+                buckets[bucketFor(keyOf(element))].push_back(element);
+            }
+        }
+
+        // Makes sure that bucket 0 holds the head if the heap is not empty.
+        bool refillBucketZero() {
+            if (!buckets[0].empty()) {
+                return true;
+            }
+            if (count == 0) {
+                return false;
+            }
+            int i = 1;
+            while (buckets[i].empty()) {
+                ++i;
+            }
+            unsigned long long minKey = keyOf(buckets[i][0]);
+            for (const auto &element : buckets[i]) {
+                if (keyOf(element) < minKey) {
+                    minKey = keyOf(element);
+                }
+            }
+            last = minKey;
+            std::vector<ValueType> redistribute;
+            redistribute.swap(buckets[i]);
+            for (const auto &element : redistribute) {
+                buckets[bucketFor(keyOf(element))].push_back(element);
+            }
+            redistribute.clear();
+            redistribute.swap(buckets[i]); // Give the (now empty) bucket its capacity back for later reuse.
+            return true;
+        }
+        
+        std::vector<std::vector<ValueType> > buckets;
+        unsigned long long last;
+        unsigned long long lastPopped;  // Inserts below this are refused. 0 until a pop, and again once empty.
+        size_t count;
+        KeyExtractor keyOf;
+    }; // CS : RadixHeap
+    
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_RADIX_HEAP_H
@@ -0,0 +1,428 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_RED_BLACK_SET_OPERATIONS_H
+#define APFN_DATA_STRUCTURES_RED_BLACK_SET_OPERATIONS_H
+
+#include <cstddef>  // size_t
+
+#include "stack.h"
+#include "fork_join_pool.h"
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+
+namespace vvalgo {
+
+    /*
+     * Join, split and the set operations built on them, for the red-black trees of red_black_tree.h.
+     *
+     * join(left, node, right) links two trees and a node between them in time proportional to the difference of
+     * their black heights, by walking down the taller one's spine to a black node as high as the shorter tree,
+     * hanging the shorter tree and the node there, and fixing the one red-red pair that this can make on the way
+     * back up. split() takes a tree apart along the path to a value and joins the pieces back up on either side.
+     *
+     * unite(), intersect() and subtract() split the second tree by the root of the first (or the other way
+     * round), recurse on the two halves, and join the results. That is O(m log(n/m + 1)) work for trees of m <= n
+     * nodes, so small sets go into large ones at about the cost of inserting them, and two large ones merge in
+     * linear time. The two halves share no nodes, so the versions that take a ForkJoinPool run them as parallel
+     * tasks down to a fixed depth, and sequentially below it.
+     *
+     * Every operation here takes its input trees apart and reuses their nodes: pass roots of trees you own and use
+     * the result instead. Nodes that end up in no result (duplicates, and everything dropped by intersect() and
+     * subtract()) go to release(), which defaults to NodePtrTraits<NodePtr>::destroy(). The parallel versions call
+     * it from several workers at once, so it has to be thread-safe there: delete is, a NodePool is not.
+     */
+    namespace RB {
+        namespace join_detail {
+            // A tree, and the number of black nodes on every path from its root down to a missing child.
+            template <typename NodePtr>
+            struct Tree {
+                NodePtr root;
+                size_t blackHeight;
+            };
+
+            template <typename NodePtr>
+            Tree<NodePtr> measure(NodePtr root) {
+                size_t blacks = 0;
+                for (NodePtr node = root; node; node = node->left) {
+                    blacks += !node->isRed();
+                }
+                return Tree<NodePtr>{root, blacks};
+            }
+
+            // Makes node the parent of left and right, with the given color and no parent of its own.
+            template <typename NodePtr>
+            NodePtr link(NodePtr left, NodePtr node, NodePtr right, bool red) {
+                node->left = left;
+                node->right = right;
+                node->parent = NodePtr();
+                if (left) {
+                    left->parent = node;
+                }
+                if (right) {
+                    right->parent = node;
+                }
+                node->setRed(red);
+                BST::recomputeAugmentation(node);
+                return node;
+            }
+
+            // The subtrees of t's root, cut loose from it. t's root keeps its stale child pointers until relinked.
+            template <typename NodePtr>
+            void expose(const Tree<NodePtr> &t, Tree<NodePtr> *left, Tree<NodePtr> *right) {
+                size_t below = t.blackHeight - !t.root->isRed();
+                *left = Tree<NodePtr>{t.root->left, below};
+                *right = Tree<NodePtr>{t.root->right, below};
+                if (left->root) {
+                    left->root->parent = NodePtr();
+                }
+                if (right->root) {
+                    right->root->parent = NodePtr();
+                }
+            }
+
+            // Hangs node and right (black root, black height rightHeight) off left's right spine, where left is
+            // at least as high. The result is as high as left; only its root and its root's right child can both
+            // be red, and the caller fixes that.
+            template <typename NodePtr>
+            NodePtr joinRight(NodePtr left, size_t leftHeight, NodePtr node, NodePtr right, size_t rightHeight) {
+                if (!isRed(left) && (leftHeight == rightHeight)) {
+                    return link(left, node, right, true);
+                }
+                bool red = left->isRed();
+                NodePtr joined = joinRight(left->right, leftHeight - !red, node, right, rightHeight);
+                link(left->left, left, joined, red);
+                if (!red && isRed(joined) && isRed(joined->right)) { // Rotate the red pair's top up to here.
+                    joined->right->setRed(false);
+                    NodePtr outer = joined->right;
+                    link(left->left, left, joined->left, false);
+                    return link(left, joined, outer, true);
+                }
+                return left;
+            }
+
+            // The mirror image of joinRight().
+            template <typename NodePtr>
+            NodePtr joinLeft(NodePtr left, size_t leftHeight, NodePtr node, NodePtr right, size_t rightHeight) {
+                if (!isRed(right) && (leftHeight == rightHeight)) {
+                    return link(left, node, right, true);
+                }
+                bool red = right->isRed();
+                NodePtr joined = joinLeft(left, leftHeight, node, right->left, rightHeight - !red);
+                link(joined, right, right->right, red);
+                if (!red && isRed(joined) && isRed(joined->left)) {
+                    joined->left->setRed(false);
+                    NodePtr outer = joined->left;
+                    link(joined->right, right, right->right, false);
+                    return link(outer, joined, right, true);
+                }
+                return right;
+            }
+
+            template <typename NodePtr>
+            void blacken(Tree<NodePtr> *t) {
+                if (isRed(t->root)) {
+                    t->root->setRed(false);
+                    ++t->blackHeight;
+                }
+            }
+
+            template <typename NodePtr>
+            Tree<NodePtr> join(Tree<NodePtr> left, NodePtr node, Tree<NodePtr> right) {
+                blacken(&left); // So that the spine walks start on black, and a red node can go under either.
+                blacken(&right);
+                if (left.blackHeight > right.blackHeight) {
+                    return Tree<NodePtr>{joinRight(left.root, left.blackHeight, node, right.root, right.blackHeight),
+                                         left.blackHeight};
+                }
+                if (left.blackHeight < right.blackHeight) {
+                    return Tree<NodePtr>{joinLeft(left.root, left.blackHeight, node, right.root, right.blackHeight),
+                                         right.blackHeight};
+                }
+                return Tree<NodePtr>{link(left.root, node, right.root, true), left.blackHeight};
+            }
+
+            // Splits t into the values below val and those above, and returns the node holding val, cut loose,
+            // or null.
+            template <typename NodePtr, typename ValueType>
+            NodePtr split(Tree<NodePtr> t, const ValueType &val, Tree<NodePtr> *less, Tree<NodePtr> *greater) {
+                if (!t.root) {
+                    *less = *greater = t;
+                    return NodePtr();
+                }
+                Tree<NodePtr> left, right, middle;
+                expose(t, &left, &right);
+                NodePtr found;
+                if (val < t.root->value) {
+                    found = split(left, val, less, &middle);
+                    *greater = join(middle, t.root, right);
+                } else if (t.root->value < val) {
+                    found = split(right, val, &middle, greater);
+                    *less = join(left, t.root, middle);
+                } else {
+                    *less = left;
+                    *greater = right;
+                    found = link(NodePtr(), t.root, NodePtr(), false);
+                }
+                return found;
+            }
+
+            // Takes the largest node out of t, which must not be empty.
+            template <typename NodePtr>
+            NodePtr splitLast(Tree<NodePtr> t, Tree<NodePtr> *rest) {
+                Tree<NodePtr> left, right;
+                expose(t, &left, &right);
+                if (!right.root) {
+                    *rest = left;
+                    return link(NodePtr(), t.root, NodePtr(), false);
+                }
+                NodePtr last = splitLast(right, &right);
+                *rest = join(left, t.root, right);
+                return last;
+            }
+
+            // Every value in left is below every value in right.
+            template <typename NodePtr>
+            Tree<NodePtr> concatenate(const Tree<NodePtr> &left, const Tree<NodePtr> &right) {
+                if (!left.root) {
+                    return right;
+                }
+                if (!right.root) {
+                    return left;
+                }
+                Tree<NodePtr> rest;
+                NodePtr last = splitLast(left, &rest);
+                return join(rest, last, right);
+            }
+
+            template <typename NodePtr, typename Release>
+            void releaseTree(NodePtr root, Release &release) {
+                Stack<NodePtr, 64> pending;
+                if (root) {
+                    pending.push(root);
+                }
+                NodePtr node;
+                while (pending.pop(node)) {
+                    if (node->left) {
+                        pending.push(node->left);
+                    }
+                    if (node->right) {
+                        pending.push(node->right);
+                    }
+                    node->left = node->right = node->parent = NodePtr();
+                    release(node);
+                }
+            }
+
+            // Runs both, as parallel tasks while forks are left.
+            template <typename F1, typename F2>
+            void both(ForkJoinPool *pool, size_t forks, F1 &&f1, F2 &&f2) {
+                if (pool && forks) {
+                    pool->invoke(f1, f2);
+                } else {
+                    f1();
+                    f2();
+                }
+            }
+
+            template <typename NodePtr, typename Release>
+            Tree<NodePtr> unite(ForkJoinPool *pool, size_t forks, const Tree<NodePtr> &a, const Tree<NodePtr> &b,
+                                Release &release) {
+                if (!a.root) {
+                    return b;
+                }
+                if (!b.root) {
+                    return a;
+                }
+                Tree<NodePtr> aLeft, aRight, bLeft, bRight, left, right;
+                expose(a, &aLeft, &aRight);
+                if (NodePtr duplicate = split(b, a.root->value, &bLeft, &bRight)) {
+                    release(duplicate);
+                }
+                size_t below = forks ? forks - 1 : 0;
+                both(pool, forks, [&]() {left = unite(pool, below, aLeft, bLeft, release);},
+                                  [&]() {right = unite(pool, below, aRight, bRight, release);});
+                return join(left, a.root, right);
+            }
+
+            template <typename NodePtr, typename Release>
+            Tree<NodePtr> intersect(ForkJoinPool *pool, size_t forks, const Tree<NodePtr> &a,
+                                    const Tree<NodePtr> &b, Release &release) {
+                if (!a.root || !b.root) {
+                    releaseTree(a.root, release);
+                    releaseTree(b.root, release);
+                    return Tree<NodePtr>{NodePtr(), 0};
+                }
+                Tree<NodePtr> aLeft, aRight, bLeft, bRight, left, right;
+                expose(a, &aLeft, &aRight);
+                NodePtr duplicate = split(b, a.root->value, &bLeft, &bRight);
+                size_t below = forks ? forks - 1 : 0;
+                both(pool, forks, [&]() {left = intersect(pool, below, aLeft, bLeft, release);},
+                                  [&]() {right = intersect(pool, below, aRight, bRight, release);});
+                if (duplicate) {
+                    release(duplicate);
+                    return join(left, a.root, right);
+                }
+                release(link(NodePtr(), a.root, NodePtr(), false));
+                return concatenate(left, right);
+            }
+
+            template <typename NodePtr, typename Release>
+            Tree<NodePtr> subtract(ForkJoinPool *pool, size_t forks, const Tree<NodePtr> &a, const Tree<NodePtr> &b,
+                                   Release &release) {
+                if (!a.root || !b.root) {
+                    releaseTree(b.root, release);
+                    return a;
+                }
+                Tree<NodePtr> aLeft, aRight, bLeft, bRight, left, right;
+                expose(b, &bLeft, &bRight);
+                if (NodePtr duplicate = split(a, b.root->value, &aLeft, &aRight)) {
+                    release(duplicate);
+                }
+                size_t below = forks ? forks - 1 : 0;
+                both(pool, forks, [&]() {left = subtract(pool, below, aLeft, bLeft, release);},
+                                  [&]() {right = subtract(pool, below, aRight, bRight, release);});
+                release(link(NodePtr(), b.root, NodePtr(), false));
+                return concatenate(left, right);
+            }
+
+            // The root of a finished tree is black, as RB::isValid() expects.
+            template <typename NodePtr>
+            NodePtr finish(const Tree<NodePtr> &t) {
+                if (t.root) {
+                    t.root->setRed(false);
+                }
+                return t.root;
+            }
+
+            // About eight tasks per worker, as in parallelTreeReduce().
+            inline size_t defaultForks(const ForkJoinPool &pool) {
+                size_t forks = 3;
+                for (int tasks = 1; tasks < pool.threadCount(); tasks *= 2) {
+                    ++forks;
+                }
+                return forks;
+            }
+
+            template <typename NodePtr>
+            struct Destroy {
+                void operator()(NodePtr node) const {NodePtrTraits<NodePtr>::destroy(node);}
+            };
+
+            // Runs one of the operations above on the pool, or right here without one.
+            template <typename NodePtr, typename Operation>
+            NodePtr run(ForkJoinPool *pool, NodePtr a, NodePtr b, Operation operation) {
+                Tree<NodePtr> result;
+                Tree<NodePtr> first = measure(a), second = measure(b);
+                if (pool) {
+                    size_t forks = defaultForks(*pool);
+                    pool->run([&]() {result = operation(pool, forks, first, second);});
+                } else {
+                    result = operation(nullptr, 0, first, second);
+                }
+                return finish(result);
+            }
+        } // NS : join_detail
+
+        // Links left, node and right into one tree. Every value in left must be below node's and every value in
+        // right above it; node must not be in either tree. O(log n), most of it spent measuring black heights.
+        template <typename NodePtr>
+        NodePtr join(NodePtr left, NodePtr node, NodePtr right) {
+            return join_detail::finish(join_detail::join(join_detail::measure(left), node,
+                                                         join_detail::measure(right)));
+        }
+
+        // Same as above without a node in between: every value in left must be below every value in right.
+        template <typename NodePtr>
+        NodePtr join(NodePtr left, NodePtr right) {
+            return join_detail::finish(join_detail::concatenate(join_detail::measure(left),
+                                                                join_detail::measure(right)));
+        }
+
+        // Takes the tree at root apart into the values below val (*less) and those above it (*greater), in
+        // O(log n). Returns the node that held val, on its own, or null if there was none.
+        template <typename NodePtr, typename ValueType>
+        NodePtr split(NodePtr root, const ValueType &val, NodePtr *less, NodePtr *greater) {
+            join_detail::Tree<NodePtr> lower, upper;
+            NodePtr found = join_detail::split(join_detail::measure(root), val, &lower, &upper);
+            *less = join_detail::finish(lower);
+            *greater = join_detail::finish(upper);
+            return found;
+        }
+
+        // Every value in a or b. Where both have a value, a's node is kept and b's is released.
+        template <typename NodePtr, typename Release = join_detail::Destroy<NodePtr> >
+        NodePtr unite(NodePtr a, NodePtr b, Release release = Release()) {
+            return join_detail::run(nullptr, a, b, [&release](ForkJoinPool *p, size_t f,
+                                                               const join_detail::Tree<NodePtr> &x,
+                                                               const join_detail::Tree<NodePtr> &y) {
+                return join_detail::unite(p, f, x, y, release);
+            });
+        }
+
+        template <typename NodePtr, typename Release = join_detail::Destroy<NodePtr> >
+        NodePtr unite(ForkJoinPool &pool, NodePtr a, NodePtr b, Release release = Release()) {
+            return join_detail::run(&pool, a, b, [&release](ForkJoinPool *p, size_t f,
+                                                             const join_detail::Tree<NodePtr> &x,
+                                                             const join_detail::Tree<NodePtr> &y) {
+                return join_detail::unite(p, f, x, y, release);
+            });
+        }
+
+        // Values in both a and b, in a's nodes.
+        template <typename NodePtr, typename Release = join_detail::Destroy<NodePtr> >
+        NodePtr intersect(NodePtr a, NodePtr b, Release release = Release()) {
+            return join_detail::run(nullptr, a, b, [&release](ForkJoinPool *p, size_t f,
+                                                               const join_detail::Tree<NodePtr> &x,
+                                                               const join_detail::Tree<NodePtr> &y) {
+                return join_detail::intersect(p, f, x, y, release);
+            });
+        }
+
+        template <typename NodePtr, typename Release = join_detail::Destroy<NodePtr> >
+        NodePtr intersect(ForkJoinPool &pool, NodePtr a, NodePtr b, Release release = Release()) {
+            return join_detail::run(&pool, a, b, [&release](ForkJoinPool *p, size_t f,
+                                                             const join_detail::Tree<NodePtr> &x,
+                                                             const join_detail::Tree<NodePtr> &y) {
+                return join_detail::intersect(p, f, x, y, release);
+            });
+        }
+
+        // Values in a but not in b.
+        template <typename NodePtr, typename Release = join_detail::Destroy<NodePtr> >
+        NodePtr subtract(NodePtr a, NodePtr b, Release release = Release()) {
+            return join_detail::run(nullptr, a, b, [&release](ForkJoinPool *p, size_t f,
+                                                               const join_detail::Tree<NodePtr> &x,
+                                                               const join_detail::Tree<NodePtr> &y) {
+                return join_detail::subtract(p, f, x, y, release);
+            });
+        }
+
+        template <typename NodePtr, typename Release = join_detail::Destroy<NodePtr> >
+        NodePtr subtract(ForkJoinPool &pool, NodePtr a, NodePtr b, Release release = Release()) {
+            return join_detail::run(&pool, a, b, [&release](ForkJoinPool *p, size_t f,
+                                                             const join_detail::Tree<NodePtr> &x,
+                                                             const join_detail::Tree<NodePtr> &y) {
+                return join_detail::subtract(p, f, x, y, release);
+            });
+        }
+    } // NS : RB
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_RED_BLACK_SET_OPERATIONS_H
@@ -0,0 +1,584 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_RED_BLACK_TREE_H
+#define APFN_DATA_STRUCTURES_RED_BLACK_TREE_H
+
+#include <cstddef>      // size_t
+#include <vector>       // Nodes in order, for bulk building.
+#include <algorithm>    // std::sort, std::unique
+#include <iterator>     // std::iterator_traits
+#include <utility>      // std::declval
+
+#include "stack.h"
+#include "node_pool.h"
+#include "binary_search_tree.h"
+
+namespace vvalgo {
+
+    template <typename ValueType>
+    class RBTree {
+    public:
+        ValueType value;
+        bool red;
+        RBTree *left;   // TODO: convert to unique_ptr
+        RBTree *right;  // TODO: convert to unique_ptr
+        RBTree *parent; // TODO: should NOT convert to unique_ptr. We need weak_ptr here.
+
+        // It is important to always allocate RBTree objects on the heap because we are calling delete
+        // in the destructor for the children. Except for the root, every node in the RBTree needs to be
+        // allocated on the heap for this to work correctly. The ideal way would be to not use this exception and
+        // just allocate the root on the heap as well.
+        // A node starts out black. RB::insert() colors the nodes it adds.
+        RBTree(ValueType val, RBTree *l=nullptr, RBTree *r = nullptr, RBTree *p = nullptr) : value(val), red(false), left(l), right(r), parent(p) {}
+
+        ~RBTree() {
+            deleteSubtree(left);
+            deleteSubtree(right);
+        }
+
+        bool isRed() const {return red;}
+        void setRed(bool r) {red = r;}
+
+        // Insertion and removal can rotate a different node into the root, so they cannot be members of the
+        // node. They live in namespace RB below and take the address of the root pointer, like BST's.
+    }; // CS : RBTree
+
+    /*
+     * Red-black tree operations on top of the BST ones, for any node with value, left, right and parent
+     * members and isRed()/setRed() (RBTree, or CompactRBNode from compact_tree.h), through any NodePtr.
+     * The tree is an ordered set: inserting a value that is already there returns the existing node.
+     *
+     * The usual invariants keep the height at most 2 log2(n + 1): the root is black, a red node has no red
+     * children, and every path from a node down to a missing child passes the same number of black nodes.
+     * Insertion and removal restore them with at most three rotations, walking back up through the parent
+     * links rather than recursing. BST::find(), BST::min() and BST::depth() work on these trees unchanged.
+     * Removal relinks nodes rather than copying values between them, so pointers to other nodes stay valid.
+     * Augmented nodes (see BST::recomputeAugmentation()) are kept up to date through all of it.
+     */
+    namespace RB {
+        template <typename NodePtr>
+        bool isRed(NodePtr node) {return node && node->isRed();} // Missing children count as black.
+
+        // Turns x's right child into x's parent.
+        template <typename NodePtr>
+        void rotateLeft(NodePtr *root, NodePtr x) {
+            NodePtr y = x->right;
+            x->right = y->left;
+            if (y->left) {
+                y->left->parent = x;
+            }
+            NodePtr parent = x->parent;
+            y->parent = parent;
+            if (!parent) {
+                *root = y;
+            } else if (x == parent->left) {
+                parent->left = y;
+            } else {
+                parent->right = y;
+            }
+            y->left = x;
+            x->parent = y;
+            BST::recomputeAugmentation(x); // y's subtree holds what x's did, so nothing above y changes.
+            BST::recomputeAugmentation(y);
+        }
+
+        // Turns x's left child into x's parent.
+        template <typename NodePtr>
+        void rotateRight(NodePtr *root, NodePtr x) {
+            NodePtr y = x->left;
+            x->left = y->right;
+            if (y->right) {
+                y->right->parent = x;
+            }
+            NodePtr parent = x->parent;
+            y->parent = parent;
+            if (!parent) {
+                *root = y;
+            } else if (x == parent->right) {
+                parent->right = y;
+            } else {
+                parent->left = y;
+            }
+            y->right = x;
+            x->parent = y;
+            BST::recomputeAugmentation(x);
+            BST::recomputeAugmentation(y);
+        }
+
+        // Restores the invariants after node was linked in as a leaf.
+        template <typename NodePtr>
+        void insertFixup(NodePtr *root, NodePtr node) {
+            node->setRed(true);
+            while (true) {
+                NodePtr parent = node->parent;
+                if (!isRed(parent)) {
+                    break;
+                }
+                NodePtr grandParent = parent->parent; // A red parent is never the root, so this exists.
+                if (parent == grandParent->left) {
+                    NodePtr uncle = grandParent->right;
+                    if (isRed(uncle)) {         // Push the grandparent's black down a level and go on from there.
+                        parent->setRed(false);
+                        uncle->setRed(false);
+                        grandParent->setRed(true);
+                        node = grandParent;
+                        continue;
+                    }
+                    if (node == parent->right) { // Make the red pair line up on the outside.
+                        rotateLeft(root, parent);
+                        node = parent;
+                        parent = node->parent;
+                    }
+                    parent->setRed(false);
+                    grandParent->setRed(true);
+                    rotateRight(root, grandParent);
+                } else {                        // Mirror image of the above.
+                    NodePtr uncle = grandParent->left;
+                    if (isRed(uncle)) {
+                        parent->setRed(false);
+                        uncle->setRed(false);
+                        grandParent->setRed(true);
+                        node = grandParent;
+                        continue;
+                    }
+                    if (node == parent->left) {
+                        rotateRight(root, parent);
+                        node = parent;
+                        parent = node->parent;
+                    }
+                    parent->setRed(false);
+                    grandParent->setRed(true);
+                    rotateLeft(root, grandParent);
+                }
+                break;
+            }
+            (*root)->setRed(false);
+        }
+
+        // Inserts val unless it is already in the tree, with the node made by create(val, parent), and returns
+        // the node holding val. If create() cannot make a node (a full CompactArena) the tree is left as it
+        // was and the result is null.
+        template <typename NodePtr, typename ValueType, typename Create>
+        NodePtr insertWith(NodePtr *root, ValueType val, Create create) {
+            NodePtr parent = NodePtr();
+            NodePtr *link = root;
+            while (*link) {
+                parent = *link;
+                if (val == parent->value) {
+                    return parent;
+                }
+                link = (val < parent->value) ? &parent->left : &parent->right;
+            }
+            NodePtr node = create(val, parent);
+            if (!node) {
+                return node;
+            }
+            *link = node;
+            BST::recomputeAugmentationUpward(node);
+            insertFixup(root, node);
+            return node;
+        }
+
+        template <typename NodePtr, typename ValueType>
+        NodePtr insert(NodePtr *root, ValueType val) {
+            return insertWith(root, val, [](const ValueType &v, NodePtr parent) {
+                return NodePtrTraits<NodePtr>::create(v, nullptr, nullptr, parent);
+            });
+        }
+
+        // Same as above, but the new node comes from pool.
+        template <typename Node, typename ValueType, size_t SlabNodes>
+        Node *insert(Node **root, ValueType val, NodePool<Node, SlabNodes> &pool) {
+            return insertWith(root, val, [&pool](const ValueType &v, Node *parent) {
+                return pool.create(v, nullptr, nullptr, parent);
+            });
+        }
+
+        /*
+         * Links nodes, which are in increasing order, into a perfectly balanced tree at *root: every node is the
+         * middle of its range, so all missing children are on the last two levels. Coloring the last level red
+         * and everything else black then satisfies every invariant without a single rotation. O(n), no recursion.
+         */
+        template <typename NodePtr>
+        void linkBalanced(NodePtr *root, const std::vector<NodePtr> &nodes) {
+            *root = NodePtr();
+            if (nodes.empty()) {
+                return;
+            }
+            size_t deepest = 0;     // floor(log2(n)), the depth of the last level.
+            for (size_t n = nodes.size(); n > 1; n >>= 1) {
+                ++deepest;
+            }
+            struct Range {
+                size_t begin;
+                size_t end;
+                NodePtr parent;
+                NodePtr *link;
+                size_t depth;
+            };
+            Stack<Range, 64> pending;
+            pending.push(Range{0, nodes.size(), NodePtr(), root, 0});
+            std::vector<NodePtr> topDown; // Parents before children, to recompute augmentations backwards.
+            const bool augmented = decltype(BST::isAugmented(std::declval<NodePtr>()))::value;
+            Range range;
+            while (pending.pop(range)) {
+                size_t middle = range.begin + (range.end - range.begin) / 2;
+                NodePtr node = nodes[middle];
+                *range.link = node;
+                node->parent = range.parent;
+                node->left = node->right = NodePtr();
+                node->setRed( (range.depth == deepest) && (range.depth > 0) );
+                if (augmented) {
+                    topDown.push_back(node);
+                }
+                if (range.begin < middle) {
+                    pending.push(Range{range.begin, middle, node, &node->left, range.depth + 1});
+                }
+                if (middle + 1 < range.end) {
+                    pending.push(Range{middle + 1, range.end, node, &node->right, range.depth + 1});
+                }
+            }
+            for (size_t i = topDown.size(); i-- > 0; ) {
+                BST::recomputeAugmentation(topDown[i]);
+            }
+        }
+
+        // Builds a tree from the values in [first, last), which must be in increasing order (repeats are skipped),
+        // with the nodes made by create(val, parent), in O(n). Returns false, and makes nothing, if *root is not
+        // empty or the values are out of order. Values create() cannot make a node for are left out.
+        template <typename NodePtr, typename Iterator, typename Create>
+        bool buildWith(NodePtr *root, Iterator first, Iterator last, Create create) {
+            if (*root) {
+                return false;
+            }
+            for (Iterator previous = first, it = first; it != last; previous = it++) {
+                if ( (it != first) && (*it < *previous) ) {
+                    return false;
+                }
+            }
+            std::vector<NodePtr> nodes;
+            for (Iterator it = first; it != last; ++it) {
+                if (nodes.empty() || (nodes.back()->value < *it)) {
+                    if (NodePtr node = create(*it, NodePtr())) {
+                        nodes.push_back(node);
+                    }
+                }
+            }
+            linkBalanced(root, nodes);
+            return true;
+        }
+
+        template <typename NodePtr, typename Iterator>
+        bool build(NodePtr *root, Iterator first, Iterator last) {
+            typedef typename std::iterator_traits<Iterator>::value_type ValueType;
+            return buildWith(root, first, last, [](const ValueType &v, NodePtr parent) {
+                return NodePtrTraits<NodePtr>::create(v, nullptr, nullptr, parent);
+            });
+        }
+
+        // Same as above, with the nodes from pool. Made one after the other, they sit next to each other in its
+        // slabs, in key order, which is what in-order scans like best.
+        template <typename Node, typename Iterator, size_t SlabNodes>
+        bool build(Node **root, Iterator first, Iterator last, NodePool<Node, SlabNodes> &pool) {
+            typedef typename std::iterator_traits<Iterator>::value_type ValueType;
+            return buildWith(root, first, last, [&pool](const ValueType &v, Node *parent) {
+                return pool.create(v, nullptr, nullptr, parent);
+            });
+        }
+
+        /*
+         * Inserts a batch of values, in any order, with the nodes made by create(val, parent). The batch is sorted
+         * first. A batch that is small next to the tree goes in one value at a time, in order, which keeps the
+         * path to the next insertion point in cache. A large one is merged with the tree's nodes in a single
+         * in-order pass and everything is relinked by linkBalanced(): O(n + m log m) in all. Existing nodes are
+         * reused either way, so pointers to them stay valid. Values create() cannot make a node for are left out.
+         */
+        template <typename NodePtr, typename ValueType, typename Create>
+        void insertBatchWith(NodePtr *root, std::vector<ValueType> batch, Create create) {
+            std::sort(batch.begin(), batch.end());
+            batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+            if (batch.empty()) {
+                return;
+            }
+            // The black nodes down the left spine give the black height b, and with it n >= 2^b - 1 and a height of
+            // at most 2b + 1, without walking the tree.
+            size_t black = 0;
+            for (NodePtr node = *root; node; node = node->left) {
+                black += !isRed(node);
+            }
+            const size_t atLeast = (black < 8 * sizeof(size_t)) ? (size_t(1) << black) - 1 : ~size_t(0);
+            if (batch.size() * (2 * black + 1) < atLeast / 4) {
+                for (const ValueType &val : batch) {
+                    insertWith(root, val, create);
+                }
+                return;
+            }
+            std::vector<NodePtr> merged;
+            merged.reserve(atLeast + batch.size());
+            auto next = batch.begin();
+            for (NodePtr node = BST::min(*root); node; node = BST::successor(node)) {
+                for (; (next != batch.end()) && (*next < node->value); ++next) {
+                    if (NodePtr made = create(*next, NodePtr())) {
+                        merged.push_back(made);
+                    }
+                }
+                if ( (next != batch.end()) && !(node->value < *next) ) {
+                    ++next; // Already in the tree.
+                }
+                merged.push_back(node);
+            }
+            for (; next != batch.end(); ++next) {
+                if (NodePtr made = create(*next, NodePtr())) {
+                    merged.push_back(made);
+                }
+            }
+            linkBalanced(root, merged);
+        }
+
+        template <typename NodePtr, typename ValueType>
+        void insertBatch(NodePtr *root, const std::vector<ValueType> &batch) {
+            insertBatchWith(root, batch, [](const ValueType &v, NodePtr parent) {
+                return NodePtrTraits<NodePtr>::create(v, nullptr, nullptr, parent);
+            });
+        }
+
+        template <typename Node, typename ValueType, size_t SlabNodes>
+        void insertBatch(Node **root, const std::vector<ValueType> &batch, NodePool<Node, SlabNodes> &pool) {
+            insertBatchWith(root, batch, [&pool](const ValueType &v, Node *parent) {
+                return pool.create(v, nullptr, nullptr, parent);
+            });
+        }
+
+        // Puts replacement (which may be null) where node is in the tree.
+        template <typename NodePtr>
+        void transplant(NodePtr *root, NodePtr node, NodePtr replacement) {
+            NodePtr parent = node->parent;
+            if (!parent) {
+                *root = replacement;
+            } else if (node == parent->left) {
+                parent->left = replacement;
+            } else {
+                parent->right = replacement;
+            }
+            if (replacement) {
+                replacement->parent = parent;
+            }
+        }
+
+        // Restores the invariants after a black node was taken out from above x, which is short of one black
+        // on all its paths. x may be missing, which is why its parent is passed in as well.
+        template <typename NodePtr>
+        void removeFixup(NodePtr *root, NodePtr x, NodePtr parent) {
+            while ( (x != *root) && !isRed(x) ) {
+                if (x == parent->left) {
+                    NodePtr sibling = parent->right; // Has at least one black below it, so it exists.
+                    if (isRed(sibling)) {           // Make the sibling black.
+                        sibling->setRed(false);
+                        parent->setRed(true);
+                        rotateLeft(root, parent);
+                        sibling = parent->right;
+                    }
+                    if (!isRed(sibling->left) && !isRed(sibling->right)) { // Take a black off both sides, go up.
+                        sibling->setRed(true);
+                        x = parent;
+                        parent = x->parent;
+                        continue;
+                    }
+                    if (!isRed(sibling->right)) {   // Make the sibling's outer child the red one.
+                        sibling->left->setRed(false);
+                        sibling->setRed(true);
+                        rotateRight(root, sibling);
+                        sibling = parent->right;
+                    }
+                    sibling->setRed(parent->isRed()); // Rotate a black over to x's side. Done.
+                    parent->setRed(false);
+                    sibling->right->setRed(false);
+                    rotateLeft(root, parent);
+                } else {                            // Mirror image of the above.
+                    NodePtr sibling = parent->left;
+                    if (isRed(sibling)) {
+                        sibling->setRed(false);
+                        parent->setRed(true);
+                        rotateRight(root, parent);
+                        sibling = parent->left;
+                    }
+                    if (!isRed(sibling->left) && !isRed(sibling->right)) {
+                        sibling->setRed(true);
+                        x = parent;
+                        parent = x->parent;
+                        continue;
+                    }
+                    if (!isRed(sibling->left)) {
+                        sibling->right->setRed(false);
+                        sibling->setRed(true);
+                        rotateLeft(root, sibling);
+                        sibling = parent->left;
+                    }
+                    sibling->setRed(parent->isRed());
+                    parent->setRed(false);
+                    sibling->left->setRed(false);
+                    rotateRight(root, parent);
+                }
+                x = *root;
+            }
+            if (x) {
+                x->setRed(false);
+            }
+        }
+
+        // Unlinks node from the tree, rebalances, and hands node to dispose(), which has to free it.
+        template <typename NodePtr, typename Dispose>
+        void removeNode(NodePtr *root, NodePtr node, Dispose dispose) {
+            NodePtr x, xParent;
+            bool removedBlack = !node->isRed();
+            if (!node->left) {
+                x = node->right;
+                xParent = node->parent;
+                transplant(root, node, x);
+            } else if (!node->right) {
+                x = node->left;
+                xParent = node->parent;
+                transplant(root, node, x);
+            } else {                        // Two children: the successor takes node's place and color.
+                NodePtr successor = BST::min(node->right);
+                removedBlack = !successor->isRed();
+                x = successor->right;
+                if (successor == node->right) {
+                    xParent = successor;
+                } else {
+                    xParent = successor->parent;
+                    transplant(root, successor, x);
+                    successor->right = node->right;
+                    successor->right->parent = successor;
+                }
+                transplant(root, node, successor);
+                successor->left = node->left;
+                successor->left->parent = successor;
+                successor->setRed(node->isRed());
+            }
+            node->left = node->right = nullptr;
+            node->parent = nullptr;
+            dispose(node);
+            BST::recomputeAugmentationUpward(xParent); // Everything that moved or lost a node is on this path.
+            if (removedBlack) {
+                removeFixup(root, x, xParent);
+            }
+        }
+
+        // Removes val from the tree. Returns false if it was not there.
+        template <typename NodePtr, typename ValueType>
+        bool remove(NodePtr *root, ValueType val) {
+            NodePtr node = BST::find(*root, val);
+            if (!node) {
+                return false;
+            }
+            removeNode(root, node, [](NodePtr n) {NodePtrTraits<NodePtr>::destroy(n);});
+            return true;
+        }
+
+        // Same as above, for trees whose nodes come from pool.
+        template <typename Node, typename ValueType, size_t SlabNodes>
+        bool remove(Node **root, ValueType val, NodePool<Node, SlabNodes> &pool) {
+            Node *node = BST::find(*root, val);
+            if (!node) {
+                return false;
+            }
+            removeNode(root, node, [&pool](Node *n) {pool.destroy(n);});
+            return true;
+        }
+
+        // Number of nodes on the longest path from the root down, without recursion.
+        template <typename NodePtr>
+        size_t height(NodePtr root) {
+            struct Frame {
+                NodePtr node;
+                size_t depth;
+            };
+            Stack<Frame, 64> pending;
+            size_t tallest = 0;
+            if (root) {
+                pending.push(Frame{root, 1});
+            }
+            Frame frame;
+            while (pending.pop(frame)) {
+                tallest = (frame.depth > tallest) ? frame.depth : tallest;
+                if (frame.node->left) {
+                    pending.push(Frame{frame.node->left, frame.depth + 1});
+                }
+                if (frame.node->right) {
+                    pending.push(Frame{frame.node->right, frame.depth + 1});
+                }
+            }
+            return tallest;
+        }
+
+        /*
+         * Checks every red-black invariant, plus search order (strictly increasing, since this is a set) and
+         * that every child points back at its parent. Meant for tests: it visits the whole tree.
+         */
+        template <typename NodePtr>
+        bool isValid(NodePtr root) {
+            if (!root) {
+                return true;
+            }
+            if (root->isRed() || root->parent) {
+                return false;
+            }
+            struct Frame {
+                NodePtr node;
+                NodePtr low;    // The nearest ancestor that node is to the right of, if any.
+                NodePtr high;   // The nearest ancestor that node is to the left of, if any.
+                size_t blacks;  // Black nodes from the root down to node, node included.
+            };
+            Stack<Frame, 64> pending;
+            pending.push(Frame{root, NodePtr(), NodePtr(), 1});
+            size_t blackHeight = 0; // Of the first missing child found. All the others must match.
+            Frame frame;
+            while (pending.pop(frame)) {
+                NodePtr node = frame.node;
+                if ( (frame.low && !(frame.low->value < node->value)) ||
+                     (frame.high && !(node->value < frame.high->value)) ) {
+                    return false;
+                }
+                NodePtr children[2] = {node->left, node->right};
+                for (int i = 0; i < 2; ++i) {
+                    NodePtr child = children[i];
+                    if (!child) {
+                        if (!blackHeight) {
+                            blackHeight = frame.blacks;
+                        } else if (blackHeight != frame.blacks) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    if ( (NodePtr(child->parent) != node) || (node->isRed() && child->isRed()) ) {
+                        return false;
+                    }
+                    pending.push(Frame{child, i ? node : frame.low, i ? frame.high : node,
+                                       frame.blacks + (child->isRed() ? 0 : 1)});
+                }
+            }
+            return true;
+        }
+
+    } // NS : RB
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_RED_BLACK_TREE_H
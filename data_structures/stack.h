@@ -11,16 +11,123 @@
  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  *  GNU General Public License for more details.
- *  
+ *
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef APFN_DATA_STRUCTURES_STACK_H
+#define APFN_DATA_STRUCTURES_STACK_H
+
 #include <vector>
+#include <cstddef>  // size_t
+#include <new>      // placement new
+#include <utility>  // std::move, std::forward, std::swap
+#include <type_traits>  // std::is_nothrow_move_constructible
 
 namespace vvalgo {
 
-template <typename T>
+/*
+ * Overflow storage for deep stacks made of fixed size chunks linked back to front. Unlike a vector it never
+ * reallocates, so growing never copies the existing items or briefly needs twice the memory, and every
+ * emplace_back() is O(1) in the worst case. The most recently emptied chunk is kept as a spare, so a stack
+ * that keeps crossing a chunk boundary does not allocate and free a chunk each time.
+ *
+ * It offers the subset of the std::vector interface that Stack uses.
+ */
+template <typename T, size_t ChunkCapacity = 1024>
+class SegmentedOverflow {
+public:
+SegmentedOverflow() : topChunk(nullptr), spare(nullptr), count(0) {}
+
+SegmentedOverflow(const SegmentedOverflow &other) : topChunk(nullptr), spare(nullptr), count(0) {
+	std::vector<const Chunk *> chunks; // Bottom to top, so that items are copied in stack order.
+	for (const Chunk *chunk = other.topChunk; chunk; chunk = chunk->prev) {
+		chunks.push_back(chunk);
+	}
+	for (auto chunk = chunks.rbegin(); chunk != chunks.rend(); ++chunk) {
+		for (size_t i = 0; i < (*chunk)->count; ++i) {
+			emplace_back(*(*chunk)->slot(i));
+		}
+	}
+}
+
+SegmentedOverflow(SegmentedOverflow &&other) noexcept : topChunk(other.topChunk), spare(other.spare), count(other.count) {
+	other.topChunk = other.spare = nullptr;
+	other.count = 0;
+}
+
+SegmentedOverflow &operator=(SegmentedOverflow other) {
+	std::swap(topChunk, other.topChunk);
+	std::swap(spare, other.spare);
+	std::swap(count, other.count);
+	return *this;
+}
+
+~SegmentedOverflow() {
+	clear();
+	delete spare;
+}
+
+template <typename... Args>
+void emplace_back(Args&&... args) {
+	if (!topChunk || (topChunk->count == ChunkCapacity)) {
+		Chunk *chunk = spare ? spare : new Chunk;
+		spare = nullptr;
+		chunk->prev = topChunk;
+		topChunk = chunk;
+	}
+	new (topChunk->slot(topChunk->count)) T(std::forward<Args>(args)...);
+	++topChunk->count;
+	++count;
+}
+
+void pop_back() {
+	--topChunk->count;
+	topChunk->slot(topChunk->count)->~T();
+	--count;
+	if (topChunk->count == 0) {
+		Chunk *emptied = topChunk;
+		topChunk = emptied->prev;
+		delete spare; // Keep at most one spare chunk around.
+		spare = emptied;
+	}
+}
+
+T &back() {return *topChunk->slot(topChunk->count - 1);}
+const T &back() const {return *topChunk->slot(topChunk->count - 1);}
+bool empty() const {return count == 0;}
+size_t size() const {return count;}
+
+void clear() {
+	while (count > 0) {
+		pop_back();
+	}
+}
+
+private:
+struct Chunk {
+	alignas(T) unsigned char items[ChunkCapacity * sizeof(T)];
+	Chunk *prev = nullptr;
+	size_t count = 0;
+	T *slot(size_t i) {return reinterpret_cast<T *>(items) + i;}
+	const T *slot(size_t i) const {return reinterpret_cast<const T *>(items) + i;}
+};
+
+Chunk *topChunk;
+Chunk *spare;
+size_t count;
+};
+
+/*
+ * The first InlineCapacity items live in a buffer inside the Stack object itself, so shallow stacks never
+ * touch the heap. Items beyond that go to the Overflow storage. The inline items never move when the stack
+ * grows past the buffer, and the overflow is only used while the stack is deeper than InlineCapacity.
+ *
+ * Overflow is std::vector<T> by default. Very deep stacks should use SegmentedOverflow<T> which never
+ * reallocates.
+ */
+template <typename T, size_t InlineCapacity = 16, typename Overflow = std::vector<T> >
 class Stack {
 
 /* 
@@ -29,36 +136,144 @@ class Stack {
  * based on trends observed in Mozilla and Google's C++ style guides. 
  */
 public:
+Stack() : inlineCount(0) {}
+
+Stack(const Stack &other) : inlineCount(0), overflow(other.overflow) {
+	for (size_t i = 0; i < other.inlineCount; ++i) {
+		new (slot(i)) T(*other.slot(i));
+		++inlineCount;
+	}
+}
+
+// noexcept whenever the items and the overflow move without throwing, so that containers of stacks move them.
+Stack(Stack &&other) noexcept(std::is_nothrow_move_constructible<T>::value &&
+                              std::is_nothrow_move_constructible<Overflow>::value)
+	: inlineCount(0), overflow(std::move(other.overflow)) {
+	for (size_t i = 0; i < other.inlineCount; ++i) {
+		new (slot(i)) T(std::move(*other.slot(i)));
+		++inlineCount;
+	}
+	other.clear();
+}
+
+Stack &operator=(Stack other) { // Copy (or move) and swap would need a swap of the inline buffers anyway, so we just rebuild.
+	clear();
+	for (size_t i = 0; i < other.inlineCount; ++i) {
+		new (slot(i)) T(std::move(*other.slot(i)));
+		++inlineCount;
+	}
+	overflow = std::move(other.overflow);
+	return *this;
+}
+
+~Stack() {
+	clear();
+}
+
 void push(const T &item) { // We have no need for modifying the item, and we need not copy it directly here either.
-	items.push_back(item);
+	emplace(item);
+}
+
+void push(T &&item) { // Temporaries are moved in rather than copied.
+	emplace(std::move(item));
+}
+
+// Constructs the new top in place from args.
+template <typename... Args>
+T &emplace(Args&&... args) {
+	if (inlineCount < InlineCapacity) {
+		T *item = new (slot(inlineCount)) T(std::forward<Args>(args)...);
+		++inlineCount;
+		return *item;
+	}
+	overflow.emplace_back(std::forward<Args>(args)...);
+	return overflow.back();
 }
 
 bool pop() {
-	if (!is_empty()) {
-		items.erase(items.begin()+items.size()-1);
-		return true;
+	if (is_empty()) {
+		return false;
+	}
+	if (onOverflow()) {
+		overflow.pop_back();
 	} else {
+		--inlineCount;
+		slot(inlineCount)->~T();
+	}
+	return true;
+}
+
+// Moves the top into item and pops it.
+bool pop(T &item) {
+	if (is_empty()) {
 		return false;
 	}
+	if (onOverflow()) {
+		item = std::move(overflow.back());
+		overflow.pop_back();
+	} else {
+		--inlineCount;
+		item = std::move(*slot(inlineCount));
+		slot(inlineCount)->~T();
+	}
+	return true;
 }
 
 bool peek(T &item) const { // Asking for a ref instead of a pointer allows us to skip nullptr checking and thus saves us from related errors/extra code.
 	if (!is_empty()) {
-		item = (items[items.size()-1]);
+		item = top();
 		return true;
 	} else {
 		return false;
 	}
 }
 
-bool is_empty() const {
-	return items.empty();
+// Reference to the top item. The stack must not be empty.
+T &top() {
+	return onOverflow() ? overflow.back() : *slot(inlineCount - 1);
+}
+
+const T &top() const {
+	return onOverflow() ? overflow.back() : *slot(inlineCount - 1);
+}
+
+bool is_empty() const { // The overflow is only used once the buffer is full, unless there is no buffer at all.
+	return (inlineCount == 0) && (InlineCapacity || overflow.empty());
+}
+
+size_t size() const {
+	return inlineCount + overflow.size();
+}
+
+void clear() {
+	overflow.clear();
+	while (inlineCount > 0) {
+		--inlineCount;
+		slot(inlineCount)->~T();
+	}
 }
 
 private:
 
-std::vector<T> items; // Backing store.
+// True if the top item lives in the overflow. The cheap inline test comes first since shallow stacks are the common case.
+bool onOverflow() const {
+	return (inlineCount == InlineCapacity) && !overflow.empty();
+}
+
+T *slot(size_t i) {
+	return reinterpret_cast<T *>(inlineItems) + i;
+}
+
+const T *slot(size_t i) const {
+	return reinterpret_cast<const T *>(inlineItems) + i;
+}
+
+alignas(T) unsigned char inlineItems[(InlineCapacity ? InlineCapacity : 1) * sizeof(T)]; // Raw storage, constructed on demand.
+size_t inlineCount;
+Overflow overflow; // Backing store for everything deeper than InlineCapacity.
 
 };
 
 }
+
+#endif // APFN_DATA_STRUCTURES_STACK_H
@@ -0,0 +1,169 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+
+#include "tree_traversal.h"
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+#include "compact_tree.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+
+typedef chrono::duration<double, milli> Ms;
+
+template <typename NodePtr>
+vector<int> values(BST::Range<NodePtr> range) {
+    vector<int> result;
+    for (auto &node : range) {
+        result.push_back(node.value);
+    }
+    return result;
+}
+
+// Bounds, ranges and stepping against std::multiset, on a tree with duplicates.
+template <typename NodePtr>
+bool matchesMultiset(NodePtr root, const multiset<int> &reference, mt19937 &generator, int valueRange) {
+    if (values(BST::all(root)) != vector<int>(reference.begin(), reference.end())) {
+        return false;
+    }
+    vector<int> backwards;
+    for (NodePtr node = BST::max(root); node; node = BST::predecessor(node)) {
+        backwards.push_back(node->value);
+    }
+    if (backwards != vector<int>(reference.rbegin(), reference.rend())) {
+        return false;
+    }
+    for (int i = 0; i < 200; ++i) {
+        int low = static_cast<int>(generator() % valueRange) - 5;
+        int high = low + static_cast<int>(generator() % 40);
+        NodePtr lower = BST::lowerBound(root, low);
+        NodePtr upper = BST::upperBound(root, low);
+        auto expectedLower = reference.lower_bound(low);
+        auto expectedUpper = reference.upper_bound(low);
+        if ( ((expectedLower == reference.end()) ? bool(lower) : (!lower || (lower->value != *expectedLower))) ||
+             ((expectedUpper == reference.end()) ? bool(upper) : (!upper || (upper->value != *expectedUpper))) ) {
+            return false;
+        }
+        if ( (values(BST::equalRange(root, low)) != vector<int>(expectedLower, expectedUpper)) ||
+             (values(BST::range(root, low, high)) != vector<int>(expectedLower, reference.lower_bound(max(low, high)))) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    RBTree<int> *root = nullptr;
+    for (int value : {50, 20, 80, 10, 30, 70, 90, 60}) {
+        RB::insert(&root, value);
+    }
+    cout << "Values in [25, 75): -> ";
+    for (auto &node : BST::range(root, 25, 75)) {
+        cout << node.value << " ";
+    }
+    cout << endl;
+    bool basics = (BST::max(root)->value == 90) && (BST::min(root)->value == 10) &&
+                  (BST::successor(BST::find(root, 30))->value == 50) && !BST::successor(BST::max(root)) &&
+                  (BST::predecessor(BST::find(root, 60))->value == 50) && !BST::predecessor(BST::min(root)) &&
+                  (BST::lowerBound(root, 55)->value == 60) && (BST::lowerBound(root, 60)->value == 60) &&
+                  (BST::upperBound(root, 60)->value == 70) && !BST::upperBound(root, 90) &&
+                  BST::range(root, 75, 75).isEmpty() && BST::range(root, 91, 1000).isEmpty() &&
+                  BST::equalRange(root, 40).isEmpty() && (values(BST::equalRange(root, 70)) == vector<int>{70});
+    cout << "max, successor, predecessor, bounds --> " << (basics ? "PASS" : "FAIL") << endl;
+    delete root;
+
+    // The same walks over an unbalanced BST with duplicates, and over a tree of 32-bit compact links.
+    mt19937 generator(42);
+    RBTree<int> *plain = nullptr;
+    CompactRBNode<int>::Ptr compact;
+    multiset<int> reference;
+    bool same = true;
+    for (int i = 0; i < 20000; ++i) {
+        int value = static_cast<int>(generator() % 1000);
+        if (generator() % 4) {
+            BST::insert(&plain, value);
+            BST::insert(&compact, value);
+            reference.insert(value);
+        } else {
+            BST::remove(&plain, value);
+            BST::remove(&compact, value);
+            if (reference.count(value)) {
+                reference.erase(reference.find(value));
+            }
+        }
+        if (!(i % 2000)) {
+            same = same && matchesMultiset(plain, reference, generator, 1000) &&
+                           matchesMultiset(compact, reference, generator, 1000);
+        }
+    }
+    cout << "Bounds and ranges match std::multiset, with duplicates --> " << (same ? "PASS" : "FAIL") << endl;
+    delete plain;
+    destroyTree(compact);
+
+    // Time windows over a day of event timestamps: a range walk against a full inorder traversal that skips
+    // everything outside the window.
+    const int EVENTS = (argc > 1) ? atoi(argv[1]) : 1000000;
+    const ll DAY = 86400000000LL; // Microseconds.
+    mt19937_64 timestamps(42);
+    RBTree<ll> *events = nullptr;
+    for (int i = 0; i < EVENTS; ++i) {
+        RB::insert(&events, static_cast<ll>(timestamps() % DAY));
+    }
+    const int WINDOWS = 10000;
+    const int SCANNED_WINDOWS = 20; // Scans are too slow to do all of them.
+    const ll WINDOW = DAY / 10000;
+    vector<ll> starts(WINDOWS);
+    for (auto &start : starts) {
+        start = static_cast<ll>(timestamps() % DAY);
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<size_t> inRanges(WINDOWS);
+    for (int i = 0; i < WINDOWS; ++i) {
+        for (auto &node : BST::range(events, starts[i], starts[i] + WINDOW)) {
+            inRanges[i] += (node.value >= starts[i]);
+        }
+    }
+    Ms rangeMs = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    bool sameEvents = true;
+    for (int i = 0; i < SCANNED_WINDOWS; ++i) {
+        size_t inScan = 0;
+        inorderTraverse(events, [&](RBTree<ll> *node) {
+            inScan += (node->value >= starts[i]) && (node->value < starts[i] + WINDOW);
+            return false;
+        });
+        sameEvents = sameEvents && (inScan == inRanges[i]);
+    }
+    Ms scanMs = chrono::steady_clock::now() - start;
+    cout << "\n" << EVENTS << " events, windows of about " << EVENTS / 10000 << " events\n";
+    cout << "range walk:\t" << rangeMs.count() * 1000 / WINDOWS << " us/window\n";
+    cout << "full scan:\t" << scanMs.count() * 1000 / SCANNED_WINDOWS << " us/window\n";
+    cout << "Same events in each window --> " << (sameEvents ? "PASS" : "FAIL") << endl;
+    delete events;
+}
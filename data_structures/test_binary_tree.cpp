@@ -16,205 +16,35 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <iostream>
-namespace vvalgo {
-
-template <typename T>
-class BinaryTree {
-public:
-T value;
-BinaryTree * lChild; // TODO: convert to unique_ptr
-BinaryTree * rChild; // TODO: convert to unique_ptr
-
-// It is important to always allocate BinaryTree objects on the heap because we are calling delete 
-// in the destructor for the children. Except for the root, every node in the BinsryTree needs to be
-// allocated on the heap for this to work correctly. The ideal way would be to not use this exception and 
-// just allocate the root on the heap as well.
-BinaryTree(T val, BinaryTree * l=nullptr, BinaryTree *r = nullptr) : value(val), lChild(l), rChild(r) {}
-
-~BinaryTree() {
-	delete lChild; // It is safe to pass nullptr to delete, so no need to check for it.
-	delete rChild; 
-}
-
-void replaceLeftChild(BinaryTree *newLChild) {
-	delete lChild;
-	lChild = newLChild;
-}
-
-void replaceRightChild(BinaryTree *newRChild) {
-	delete rChild;
-	rChild = newRChild;
-}
-
-// I'm leaving the traversal methods outside of this class because they are not tightly
-// coupled with this implementation. They only require the object to have value, *lChild and *rchild
-// public members.
-// By keeping the traversal and related methods outside, I am enabling them to work
-// on BinaryTree as well as BinarySearchTree (and potentially also on SinglyLinkedList in which I
-// could set lChild always to nullptr).
-private:
-
-}; // CS : BinaryTree
-
-/*
- * General traversal function. It invokes pre(), in() and post() callbacks in the pre-order, inorder 
- * and post-order traversal fashion.
- *
- * Important Points to Note:
- * - On Callbacks: If we perform a particular traversal, we guarantee that the relevant callback will be executed.
- * - On Traversal: Once a callback returns true, to indicate that the traversal can stop, we prevent further traversal.
- *
- * As a result of these two points, an interesting situation arises. If we have gone down the left
- * subtree and some callback returns true, do we invoke the in() callback of the node? If we had gone
- * down the right subtree and then a callback returned true, do we invoke the post() callback?
- * The answer is, yes we do. This comes from the first of the two assurances we mentioned above. If
- * we have performed a particular traversal, we will invoke the relevant callback.
- *
- * This has a very interesting repurcussions on the way you would write callbacks. Since all the pre() callbacks
- * are called once we descend down a tree, pre() will never be invoked once any of the callbacks stops the traversal.
- * in() is performed after the left subtree has been traversed (may be partially traversed if a callback stopped the
- * traversal). This means, in() should be invoked regardless of whether or not further traversal has been cancelled.
- * Similar situation applies for post(). Once we have traversed down the right subtree, we are obliged to invoke
- * post() regardless of any indications related to stopping traversal.
- *
- */
-template <typename T, typename U, typename V, typename W> // TIP: Always use different typenames for template arguments.
-                                                          // Template argument deduction is best left to the compiler. Trying
-                                                          // to force some of the apparently equivalent signatures is not a good
-                                                          // idea because template instantiation does not do type conversion, making
-                                                          // it too easy to fail during compilation.
-void traverse(T *root, U pre, V in, W post) {
-    bool stopTraversal = false;
-    std::function<void (T *)> traversalHelper = [&](T *node) {
-        if (stopTraversal || !node) {
-            return;
-        }
-        
-        if (pre(node)) { // Perform pre-order processing
-            stopTraversal = true; // I'm avoiding if (stopTraversal = foo(node)) because that has the potential to
-            // set stopTraversal to false. We don't ever want to do that except during
-            // initialization. This simple constraint on stopTraversal will help us avoid
-            // bugs where it gets reset to false after it was set to true. Once set to true,
-            // it should always remain true. Plus, that condition also has the potential of
-            // confusing future generations who might just look at it as a bug where we used
-            // a single '=' instead of '=='.
-            return;
-        }
-        
-        traversalHelper(node->lChild); // Traverse the left subtree.
-        if (in(node)) { // // Perform inorder processing.
-            stopTraversal = true;
-        }
-        if (stopTraversal) {
-            return;
-        }
-        
-        traversalHelper(node->rChild); // Traverse the righ subtree.
-        if (post(node)) { // Perform post-order processing
-            stopTraversal = true;
-        }
-    };
-    
-    // Kick off the traversal
-    traversalHelper(root);
-}
-
-/*
- * The function foo passed to the traversal function should process the node
- * and return true if it wants the traversal to continue and false if it
- * wants the traversal to stop.
- * expected signature for foo(): bool (*)(T *); // return true if you have accomplished your goal and want traversal to stop prematurely.
- * It is our responsibility to ensure that foo() is never called once it has returned true. This way,
- * all the complexity related to ensuring this lies within the traversal code rather than being spread 
- * out among all the implementations of foo(). It would incur a much higher overall test load if that
- * were the case. And that will result in less bugs in the overall system.
- */
-template <typename T, typename V>
-    void inorderTraverse(T *root, V foo) {
-    auto noop = [](T *){return false;};
-    traverse(root, noop, foo, noop);
-} // FN : inorderTraverse
-
-template <typename T, typename V>
-void preorderTraverse(T *root, V foo) {
-    auto noop = [](T *){return false;};
-    traverse(root, foo, noop, noop);
-} // FN : preorderTraverse
-
-template <typename T, typename V>
-void postorderTraverse(T *root, V foo) {
-    auto noop = [](T *){return false;};
-    traverse(root, noop, noop, foo);
-} // FN : postorderTraverse
-
-template <typename T, typename V>
-T *findNodeWithValue(T *root, V value) {
-	T *match = nullptr;
-    
-	auto finder = [&match, &value] (T *node) -> bool {
-		if ( node && (node->value == value) ) {
-			match = node;
-            return true;// True indicates that we have accomplished our task and traversal can end prematurely.
-		}
-        return false;
-	};
-
-	inorderTraverse(root, finder);
-
-	return match;
-}
-
-/*
- * This method returns a pointer to the parent node of the node with value 'value'. The problem
- * with this scenario is that if the root contains 'value' then we do not have a parent. But another
- * case where we cannot have a parent is if there is no node with value equal to 'value'. To
- * differentiate between these two situations, it is not enough to just return the pointer to the parent
- * but also to indicate, in case of failure, if the failure is a result of finding the value in the
- * root node. We allow this by asking the caller to pass a reference to a bool which we will set
- * to true, if value is found in the root. It will be set to false if no node contains the value.
- * And it's value is false if we actually found the parent node. We return the parent node
- * when found, and return nullptr otherwise.
- */
-template <typename T, typename V>
-T *findParentOfNodeWithValue(T *root, V value, bool &foundValueInRoot) {
-	T *parent = nullptr;
-	if (root && root->value == value) {
-		foundValueInRoot = true;
-		return nullptr;
-	}
-	foundValueInRoot = false;// This parameter will not be changed in the rest of the code below.
-
-	auto finder = [&parent, &value] (T *node) -> bool {
-		if (node) {
-			T *l = node->lChild;
-			if (l && (l->value == value)) {
-				parent = node;
-                return true;
-			}
-			T *r = node->rChild;
-			if (r && (r->value == value)) {
-				parent = node;
-                return true;
-			}
-		}
-        return false;
-	};
-
-	inorderTraverse(root, finder);
-
-	return parent;
-}
-
-} // NS : vvalgo
+#include "binary_tree.h"
 
 #include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstddef>
 
 using namespace std;
 using namespace vvalgo;
 
 typedef long long ll;
 
+// A node whose links count how often they are followed, to see how much of a tree a traversal touches.
+struct Counted {
+    ll value;
+    Counted *left, *right;
+    static size_t reads;
+};
+size_t Counted::reads = 0;
+
+namespace vvalgo {
+    template <>
+    struct TreeLinks<Counted> {
+        static Counted *&left(Counted *node) {++Counted::reads; return node->left;}
+        static Counted *&right(Counted *node) {++Counted::reads; return node->right;}
+    };
+}
+
 int main() {
 	auto *root = new BinaryTree<ll>{100};
 	cout << root->value << endl;
@@ -264,4 +94,249 @@ int main() {
     cout << "\nPostorder traversal\n";
     postorderTraverse(root, printer);
     cout << endl;
+
+    // The iterators visit the nodes in the same orders as the callbacks.
+    root->lChild->replaceLeftChild(new BinaryTree<ll>{25});
+    root->lChild->replaceRightChild(new BinaryTree<ll>{75});
+    root->rChild->replaceRightChild(new BinaryTree<ll>{300});
+    auto collect = [](vector<ll> &values) {
+        return [&values](const BinaryTree<ll> *node) -> bool {
+            values.push_back(node->value);
+            return false;
+        };
+    };
+    vector<ll> expected, actual;
+    traverse(root, collect(expected), dummy, dummy);
+    for (auto &node : preorder(root)) {
+        actual.push_back(node.value);
+    }
+    cout << "\nPreorder iterator matches traverse() --> " << ((actual == expected) ? "PASS" : "FAIL") << endl;
+    expected.clear(), actual.clear();
+    traverse(root, dummy, collect(expected), dummy);
+    for (auto &node : inorder(root)) {
+        actual.push_back(node.value);
+    }
+    cout << "Inorder iterator matches traverse() --> " << ((actual == expected) ? "PASS" : "FAIL") << endl;
+    expected.clear(), actual.clear();
+    traverse(root, dummy, dummy, collect(expected));
+    for (auto &node : postorder(root)) {
+        actual.push_back(node.value);
+    }
+    cout << "Postorder iterator matches traverse() --> " << ((actual == expected) ? "PASS" : "FAIL") << endl;
+    actual.clear();
+    for (auto &node : levelorder(root)) {
+        actual.push_back(node.value);
+    }
+    cout << "Level-order iterator --> " << ((actual == vector<ll>{100, 50, 200, 25, 75, 300}) ? "PASS" : "FAIL") << endl;
+
+    // Early termination is an ordinary break, and the callback is not called again after it returned true.
+    actual.clear();
+    inorderTraverse(root, [&actual](const BinaryTree<ll> *node) -> bool {
+        actual.push_back(node->value);
+        return node->value == 75;
+    });
+    cout << "Inorder traversal stops at 75 --> " << ((actual == vector<ll>{25, 50, 75}) ? "PASS" : "FAIL") << endl;
+    delete root;
+
+    // A BST built from sorted input degenerates into a list. Neither the iterators nor traverse() recurse, so
+    // walking a million levels is fine.
+    const ll DEPTH = 1000000;
+    BinaryTree<ll> *chain = nullptr;
+    for (ll i = DEPTH; i > 0; --i) {
+        chain = new BinaryTree<ll>{i, nullptr, chain};
+    }
+    ll count = 0, sum = 0;
+    for (auto &node : inorder(chain)) {
+        ++count, sum += node.value;
+    }
+    traverse(chain, dummy, dummy, [&count](const BinaryTree<ll> *) {++count; return false;});
+    cout << "Walked a " << DEPTH << " deep tree --> "
+         << ( (count == 2 * DEPTH) && (sum == DEPTH * (DEPTH + 1) / 2) ? "PASS" : "FAIL" ) << endl;
+
+    // Neither does the destructor any more.
+    delete chain;
+    cout << "Deleted a " << DEPTH << " deep tree --> PASS" << endl;
+
+    // Morris traversals visit in the same order as the iterators and leave the tree exactly as they found it,
+    // including when they are stopped half way.
+    mt19937 generator(7);
+    BinaryTree<ll> *random = nullptr;
+    for (int i = 0; i < 200000; ++i) {
+        ll value = generator() % 1000000;
+        BinaryTree<ll> **link = &random;
+        while (*link) {
+            link = (value < (*link)->value) ? &(*link)->lChild : &(*link)->rChild;
+        }
+        *link = new BinaryTree<ll>{value};
+    }
+    auto shape = [](BinaryTree<ll> *tree) {
+        vector<const void *> links;
+        for (auto &node : preorder(tree)) {
+            links.push_back(node.lChild);
+            links.push_back(node.rChild);
+        }
+        return links;
+    };
+    const vector<const void *> original = shape(random);
+    expected.clear(), actual.clear();
+    inorderTraverse(random, collect(expected));
+    morrisInorderTraverse(random, collect(actual));
+    bool morrisOk = (actual == expected) && (shape(random) == original);
+    expected.clear(), actual.clear();
+    preorderTraverse(random, collect(expected));
+    morrisPreorderTraverse(random, collect(actual));
+    morrisOk = morrisOk && (actual == expected) && (shape(random) == original);
+    for (size_t stopAfter : {1, 2, 1000, 99999, 199999}) {
+        size_t calls = 0;
+        auto stopper = [&calls, stopAfter](BinaryTree<ll> *) {return ++calls == stopAfter;};
+        morrisInorderTraverse(random, stopper);
+        morrisOk = morrisOk && (calls == stopAfter) && (shape(random) == original);
+        calls = 0;
+        morrisPreorderTraverse(random, stopper);
+        morrisOk = morrisOk && (calls == stopAfter) && (shape(random) == original);
+    }
+    cout << "Morris traversals match and restore the tree --> " << (morrisOk ? "PASS" : "FAIL") << endl;
+
+    // Stopping early only costs the climb back out: far fewer links followed than a full walk.
+    vector<Counted> counted(200000);
+    for (size_t i = 0; i < counted.size(); ++i) {
+        Counted **link = &counted[0].left;
+        counted[i] = Counted{static_cast<ll>(generator() % 1000000), nullptr, nullptr};
+        for (Counted *at = i ? &counted[0] : nullptr; at; at = *link) {
+            link = (counted[i].value < at->value) ? &at->left : &at->right;
+        }
+        if (i) {
+            *link = &counted[i];
+        }
+    }
+    Counted::reads = 0;
+    morrisInorderTraverse(&counted[0], [](Counted *) {return false;});
+    size_t fullReads = Counted::reads;
+    bool cheapStop = true;
+    for (size_t stopAfter : {1, 2, 1000, 199999}) {
+        size_t calls = 0, readsAtStop = 0;
+        auto stopper = [&calls, &readsAtStop, stopAfter](Counted *) {
+            readsAtStop = Counted::reads;
+            return ++calls == stopAfter;
+        };
+        Counted::reads = 0;
+        morrisInorderTraverse(&counted[0], stopper);
+        size_t inorderAfter = Counted::reads - readsAtStop;
+        calls = 0;
+        Counted::reads = 0;
+        morrisPreorderTraverse(&counted[0], stopper);
+        size_t preorderAfter = Counted::reads - readsAtStop;
+        cheapStop = cheapStop && (inorderAfter < fullReads / 100) && (preorderAfter < fullReads / 100);
+    }
+    cout << "Stopped Morris traversals skip the rest of the tree (" << fullReads << " link reads for a full walk) --> "
+         << (cheapStop ? "PASS" : "FAIL") << endl;
+
+    // The index and the batch lookup agree with findNodeWithValue() and findParentOfNodeWithValue().
+    BinaryTreeIndex<ll> index(random);
+    vector<ll> asked;
+    for (int i = 0; i < 300; ++i) {
+        asked.push_back(generator() % 1000000);
+    }
+    asked.push_back(random->value);
+    asked.push_back(asked.front()); // Asked twice.
+    vector<BinaryTree<ll> *> nodes, parents;
+    size_t found = findNodesWithValues(random, asked, nodes, parents);
+    bool lookups = (index.size() == 200000);
+    size_t expectedFound = 0;
+    for (size_t i = 0; i < asked.size(); ++i) {
+        BinaryTree<ll> *match = findNodeWithValue(random, asked[i]);
+        BinaryTree<ll> *indexed = index.find(asked[i]);
+        bool inRoot = false, indexedInRoot = false;
+        findParentOfNodeWithValue(random, asked[i], inRoot);
+        BinaryTree<ll> *indexedParent = index.findParent(asked[i], indexedInRoot);
+        expectedFound += (match != nullptr);
+        lookups = lookups && (nodes[i] == match) && ((indexed != nullptr) == (match != nullptr)) &&
+                  (!indexed || (indexed->value == asked[i])) && (inRoot == indexedInRoot);
+        if (match && !inRoot) { // Repeated values may be found in different nodes, so check the links.
+            lookups = lookups && parents[i] && ((parents[i]->lChild == match) || (parents[i]->rChild == match)) &&
+                      ((indexedParent->lChild == indexed) || (indexedParent->rChild == indexed));
+        }
+    }
+    lookups = lookups && (found == expectedFound);
+    cout << "Index and batch lookup match the traversals --> " << (lookups ? "PASS" : "FAIL") << endl;
+
+    // Replacing children through the index keeps it current.
+    BinaryTree<ll> *leaf = random;
+    while (leaf->lChild) {
+        leaf = leaf->lChild;
+    }
+    leaf->replaceLeftChild(new BinaryTree<ll>{-1, new BinaryTree<ll>{-2}, new BinaryTree<ll>{-3}}, index);
+    BinaryTree<ll> *grafted = leaf->lChild;
+    bool inRoot = true;
+    bool maintained = (index.size() == 200003) && (index.find(-1) == grafted) && (index.findParent(-1, inRoot) == leaf) &&
+                      !inRoot && (index.findParent(-3, inRoot) == grafted);
+    random->replaceRightChild(nullptr, index);
+    size_t remaining = 0;
+    inorderTraverse(random, [&remaining](BinaryTree<ll> *) {++remaining; return false;});
+    maintained = maintained && (index.size() == remaining) && (index.find(-2) == grafted->lChild);
+    leaf->replaceLeftChild(nullptr, index);
+    maintained = maintained && !index.find(-1) && !index.find(-3) && (index.size() == remaining - 3);
+    cout << "replaceLeftChild()/replaceRightChild() keep the index current --> " << (maintained ? "PASS" : "FAIL")
+         << endl;
+    delete random;
+
+    // Moving a subtree that is still attached elsewhere keeps one entry per node, with the new parent, even when
+    // every moved value is repeated in the tree.
+    BinaryTree<ll> *moved = new BinaryTree<ll>{5, new BinaryTree<ll>{5}};
+    BinaryTree<ll> *from = new BinaryTree<ll>{5, nullptr, moved};
+    BinaryTree<ll> *to = new BinaryTree<ll>{7};
+    BinaryTree<ll> *small = new BinaryTree<ll>{1, from, to};
+    BinaryTreeIndex<ll> smallIndex(small);
+    to->replaceRightChild(moved, smallIndex);
+    from->rChild = nullptr; // Detached by hand: the index already has moved under to.
+    bool movedOk = (smallIndex.size() == 5) && (smallIndex.findParent(7, inRoot) == small);
+    to->replaceRightChild(nullptr, smallIndex);
+    movedOk = movedOk && (smallIndex.size() == 3) && (smallIndex.find(5) == from) &&
+              (smallIndex.findParent(5, inRoot) == small) && !inRoot;
+    cout << "Moving a subtree keeps one index entry per node --> " << (movedOk ? "PASS" : "FAIL") << endl;
+    delete small;
+
+    // Thousands of lookups into an unordered tree of a million nodes: a traversal each, one batched traversal,
+    // and the index. The traversals only get a few queries; their time is per query.
+    typedef chrono::duration<double, milli> Ms;
+    const size_t NODES = 1000000, QUERIES = 5000, SCANNED = 20;
+    vector<BinaryTree<ll> *> all;
+    all.push_back(new BinaryTree<ll>{0});
+    for (size_t i = 1; i < NODES; ++i) { // Random shape, values in no order at all.
+        BinaryTree<ll> *node = new BinaryTree<ll>{static_cast<ll>(generator())};
+        BinaryTree<ll> *parent = all[generator() % all.size()];
+        while (parent->lChild && parent->rChild) {
+            parent = (generator() & 1) ? parent->lChild : parent->rChild;
+        }
+        (parent->lChild ? parent->rChild : parent->lChild) = node;
+        all.push_back(node);
+    }
+    BinaryTree<ll> *unordered = all.front();
+    vector<ll> queries;
+    for (size_t i = 0; i < QUERIES; ++i) {
+        queries.push_back(all[generator() % NODES]->value);
+    }
+    auto start = chrono::steady_clock::now();
+    size_t scanned = 0;
+    for (size_t i = 0; i < SCANNED; ++i) {
+        scanned += (findNodeWithValue(unordered, queries[i]) != nullptr);
+    }
+    Ms scanMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    size_t batched = findNodesWithValues(unordered, queries, nodes, parents);
+    Ms batchMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    BinaryTreeIndex<ll> big(unordered);
+    Ms indexBuildMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    size_t indexed = 0;
+    for (ll value : queries) {
+        indexed += (big.find(value) != nullptr);
+    }
+    Ms indexMs = chrono::steady_clock::now() - start;
+    cout << "\n" << QUERIES << " lookups in " << NODES << " nodes, ms: traversal each "
+         << scanMs.count() / SCANNED * QUERIES << " (estimated), batched " << batchMs.count() << ", index "
+         << indexMs.count() << " (+" << indexBuildMs.count() << " to build) --> "
+         << ( (scanned == SCANNED) && (batched == QUERIES) && (indexed == QUERIES) ? "PASS" : "FAIL" ) << endl;
+    delete unordered;
 }
@@ -0,0 +1,222 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+#include "tree_traversal.h"
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+#include "bplus_tree.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+
+typedef chrono::duration<double, milli> Ms;
+
+template <typename Tree>
+bool sameAs(const Tree &tree, const map<ll, ll> &reference) {
+    if (tree.size() != reference.size()) {
+        return false;
+    }
+    auto expected = reference.begin();
+    for (auto entry : tree) {
+        if ( (entry.key != expected->first) || (entry.value != expected->second) ) {
+            return false;
+        }
+        ++expected;
+    }
+    return true;
+}
+
+// Random inserts, removes and finds against std::map. Small nodes make for a deep tree that splits, borrows and
+// merges all the time.
+template <size_t NodeBytes>
+void randomOperations(const char *name, int rounds, ll keyRange) {
+    mt19937_64 generator(NodeBytes);
+    BPlusTree<ll, ll, NodeBytes> tree;
+    map<ll, ll> reference;
+    bool same = true;
+    int tallest = 0;
+    for (int i = 0; i < rounds; ++i) {
+        ll key = static_cast<ll>(generator() % keyRange);
+        switch (generator() % 4) {
+        case 0:
+        case 1: {
+            ll *value = tree.insert(key, i);
+            auto added = reference.insert(make_pair(key, ll(i)));
+            same = same && value && (*value == added.first->second);
+            break;
+        }
+        case 2:
+            same = same && (tree.remove(key) == (reference.erase(key) == 1));
+            break;
+        default: {
+            const ll *value = tree.find(key);
+            auto it = reference.find(key);
+            same = same && ((it == reference.end()) ? !value : (value && (*value == it->second)));
+        }
+        }
+        tallest = max(tallest, tree.height());
+        if (!(i % (rounds / 20))) {
+            same = same && tree.isValid() && sameAs(tree, reference);
+        }
+    }
+    same = same && tree.isValid() && sameAs(tree, reference);
+    cout << name << " (" << tree.LEAF_CAPACITY << " per leaf, " << tree.INNER_CAPACITY << " keys per inner node, up to "
+         << tallest << " levels) matches std::map --> " << (same ? "PASS" : "FAIL") << endl;
+
+    // Emptying the tree shrinks it back to a single leaf.
+    vector<ll> keys;
+    for (auto entry : tree) {
+        keys.push_back(entry.key);
+    }
+    shuffle(keys.begin(), keys.end(), generator);
+    bool emptied = true;
+    for (ll key : keys) {
+        emptied = emptied && tree.remove(key);
+    }
+    emptied = emptied && tree.isEmpty() && (tree.height() == 1) && tree.isValid() && (tree.begin() == tree.end());
+    cout << name << " removing every key --> " << (emptied ? "PASS" : "FAIL") << endl;
+}
+
+// Builds each tree from the same keys, then times random lookups and a full scan in key order.
+template <typename Build, typename Find, typename Scan>
+void benchmark(const char *name, const vector<ll> &keys, const vector<ll> &probes, Build build, Find find, Scan scan) {
+    auto start = chrono::steady_clock::now();
+    for (ll key : keys) {
+        build(key);
+    }
+    Ms buildMs = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    size_t found = 0;
+    for (ll probe : probes) {
+        found += find(probe);
+    }
+    Ms findMs = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    ll sum = scan();
+    Ms scanMs = chrono::steady_clock::now() - start;
+
+    cout << name << "\t" << buildMs.count() << "\t\t" << findMs.count() * 1e6 / probes.size() << "\t\t"
+         << scanMs.count() << "\t\t" << ((found == probes.size()) && (sum != 0) ? "PASS" : "FAIL") << endl;
+}
+
+int main(int argc, char **argv) {
+    BPlusTree<ll, ll> tree;
+    for (ll key : {50, 10, 40, 20, 30}) {
+        tree.insert(key, key * 100);
+    }
+    ll *kept = tree.insert(20, -1);
+    cout << "Inorder: -> ";
+    for (auto entry : tree) {
+        cout << entry.key << ":" << entry.value << " ";
+    }
+    cout << endl;
+    bool basics = kept && (*kept == 2000) && (tree.size() == 5) && tree.find(40) && !tree.find(45) &&
+                  (tree.lowerBound(45).key() == 50) && (tree.lowerBound(51) == tree.end()) &&
+                  tree.remove(40) && !tree.remove(40) && !tree.find(40) && (tree.size() == 4);
+    cout << "Insert keeps the first value, find, lowerBound, remove --> " << (basics ? "PASS" : "FAIL") << endl;
+
+    randomOperations<64>("64 byte nodes", 400000, 20000);
+    randomOperations<512>("512 byte nodes", 400000, 200000);
+    randomOperations<4096>("4096 byte nodes", 400000, 1000000);
+
+    // Keys inserted in order fill every leaf to the split point, which is the worst case for space.
+    BPlusTree<ll, ll> sorted;
+    const ll SORTED = 1000000;
+    for (ll key = 0; key < SORTED; ++key) {
+        sorted.insert(key, key);
+    }
+    ll next = 0;
+    for (auto it = sorted.lowerBound(SORTED / 2); it != sorted.end(); ++it) {
+        next += (it.key() == SORTED / 2 + next);
+    }
+    bool sortedOk = sorted.isValid() && (next == SORTED / 2) && (sorted.height() <= 7);
+    cout << "Sorted inserts, " << sorted.height() << " levels, scan from the middle --> " << (sortedOk ? "PASS" : "FAIL") << endl;
+    sorted.clear();
+    cout << "Clear --> " << ((sorted.isEmpty() && sorted.isValid()) ? "PASS" : "FAIL") << endl;
+
+    // Lookup and scan cost against the red-black tree. Pass 100000000 to run at the full size (about 5GB for the
+    // red-black tree and 2.5GB for the B+tree); the default keeps it to a few hundred MB.
+    const size_t KEYS = (argc > 1) ? strtoul(argv[1], nullptr, 10) : (1 << 22);
+    mt19937_64 generator(40);
+    vector<ll> keys(KEYS);
+    for (auto &key : keys) {
+        key = static_cast<ll>(generator() >> 1);
+    }
+    vector<ll> probes(keys);
+    shuffle(probes.begin(), probes.end(), generator);
+    probes.resize(min<size_t>(probes.size(), 1 << 22));
+
+    cout << "\n" << KEYS << " random 64-bit keys\n";
+    cout << "tree\t\tbuild ms\tns/find\t\tscan ms\t\tfound all\n";
+    {
+        NodePool<RBTree<ll> > pool;
+        RBTree<ll> *root = nullptr;
+        benchmark("red-black", keys, probes, [&](ll key) {
+            RB::insert(&root, key, pool);
+        }, [&](ll key) {
+            return BST::find(root, key) != nullptr;
+        }, [&]() {
+            ll sum = 0;
+            for (auto &node : inorder(root)) {
+                sum ^= node.value;
+            }
+            return sum;
+        });
+        pool.releaseAll();
+    }
+    {
+        BPlusTree<ll, ll> bplus;
+        benchmark("B+ 512B", keys, probes, [&](ll key) {
+            bplus.insert(key, key);
+        }, [&](ll key) {
+            return bplus.find(key) != nullptr;
+        }, [&]() {
+            ll sum = 0;
+            for (auto entry : bplus) {
+                sum ^= entry.value;
+            }
+            return sum;
+        });
+    }
+    {
+        BPlusTree<ll, ll, 4096> bplus;
+        benchmark("B+ 4KB", keys, probes, [&](ll key) {
+            bplus.insert(key, key);
+        }, [&](ll key) {
+            return bplus.find(key) != nullptr;
+        }, [&]() {
+            ll sum = 0;
+            for (auto entry : bplus) {
+                sum ^= entry.value;
+            }
+            return sum;
+        });
+    }
+}
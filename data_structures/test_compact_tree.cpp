@@ -0,0 +1,160 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+
+#include "tree_traversal.h"
+#include "binary_search_tree.h"
+#include "compact_tree.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef CompactRBNode<int> Compact;
+
+// The same layout as RBTree: a value and three pointers, 32 bytes for an int.
+struct PointerNode {
+    int value;
+    PointerNode *left;
+    PointerNode *right;
+    PointerNode *parent;
+    PointerNode(int val, PointerNode *l = nullptr, PointerNode *r = nullptr, PointerNode *p = nullptr)
+        : value(val), left(l), right(r), parent(p) {}
+};
+
+vector<int> contents(Compact::Ptr root) {
+    vector<int> values;
+    for (auto &node : inorder(root.get())) {
+        values.push_back(node.value);
+    }
+    return values;
+}
+
+typedef chrono::duration<double, milli> Ms;
+
+// Builds a BST from keys with nodes from create(), then looks every key up in a different order.
+template <typename NodePtr, typename Insert, typename BytesUsed>
+NodePtr benchmark(const char *name, const vector<int> &keys, const vector<int> &probes, Insert insert,
+               BytesUsed bytesUsed) {
+    NodePtr root = nullptr;
+    auto start = chrono::steady_clock::now();
+    for (int key : keys) {
+        insert(&root, key);
+    }
+    Ms buildMs = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    size_t found = 0;
+    for (int probe : probes) {
+        found += (BST::find(root, probe) != nullptr);
+    }
+    Ms findMs = chrono::steady_clock::now() - start;
+
+    size_t levels = 0;
+    for (size_t i = 0; i < probes.size(); i += 64) {
+        levels += BST::depth(BST::find(root, probes[i]));
+    }
+
+    double bytesPerNode = double(bytesUsed()) / keys.size();
+    cout << name << "\t\t" << bytesPerNode << "\t\t" << 64.0 / bytesPerNode
+         << "\t\t" << buildMs.count() << "\t" << findMs.count() * 1e6 / probes.size()
+         << "\t\t" << double(levels) / ((probes.size() + 63) / 64) << "\t" << ((found == probes.size()) ? "PASS" : "FAIL") << endl;
+    return root;
+}
+
+int main(int argc, char **argv) {
+    cout << "sizeof(CompactRBNode<int>) = " << sizeof(Compact) << ", sizeof(PointerNode) = " << sizeof(PointerNode) << endl;
+
+    // The BST functions give the same results through CompactPtr as through plain pointers.
+    mt19937 generator(11);
+    Compact::Ptr root;
+    multiset<int> reference;
+    bool same = true;
+    for (int i = 0; i < 200000; ++i) {
+        int value = static_cast<int>(generator() % 5000);
+        if (generator() % 3) {
+            BST::insert(&root, value);
+            reference.insert(value);
+        } else {
+            BST::remove(&root, value);
+            if (reference.count(value)) {
+                reference.erase(reference.find(value));
+            }
+        }
+        if (!(i % 20000)) {
+            same = same && (contents(root) == vector<int>(reference.begin(), reference.end()));
+        }
+    }
+    same = same && (contents(root) == vector<int>(reference.begin(), reference.end()));
+    same = same && (CompactArena<Compact>::instance().size() == reference.size());
+    cout << "Random inserts and removes match std::multiset --> " << (same ? "PASS" : "FAIL") << endl;
+
+    // The color bit travels with the node, not with the parent link copied into it.
+    Compact::Ptr chain;
+    BST::insert(&chain, 10);
+    BST::insert(&chain, 20);
+    Compact::Ptr last = BST::insert(&chain, 30);
+    chain->setRed(true);
+    last->setRed(true);
+    BST::remove(&chain, 20); // 30 takes its place under 10.
+    bool colorsKept = chain->isRed() && last->isRed() && (last->parent.get() == chain) && (BST::depth(last) == 2);
+    chain->setRed(false);
+    colorsKept = colorsKept && !chain->isRed() && !chain->parent && (BST::depth(chain) == 1);
+    cout << "Colors survive relinking --> " << (colorsKept ? "PASS" : "FAIL") << endl;
+    destroyTree(chain);
+    destroyTree(root);
+    cout << "Destroyed both trees --> " << (CompactArena<Compact>::instance().size() ? "FAIL" : "PASS") << endl;
+
+    // Memory and lookup cost. Pass 100000000 to run at the full size (about 1.6GB for the compact tree and
+    // 4.8GB for the malloc'ed one); the default keeps it to a few hundred MB.
+    const size_t KEYS = (argc > 1) ? strtoul(argv[1], nullptr, 10) : (1 << 22);
+    vector<int> keys(KEYS);
+    for (auto &key : keys) {
+        key = static_cast<int>(generator() & 0x7FFFFFFF);
+    }
+    vector<int> probes(keys);
+    shuffle(probes.begin(), probes.end(), generator);
+    probes.resize(min<size_t>(probes.size(), 1 << 21));
+
+    cout << "\n" << KEYS << " random keys\n";
+    cout << "nodes\t\tbytes/node\tnodes/line\tbuild ms\tns/find\tdepth\tfound all\n";
+    // glibc malloc rounds a request plus its 8 byte header up to 16 bytes, and never goes below 32.
+    const size_t MALLOC_CHUNK = max<size_t>(32, (sizeof(PointerNode) + 8 + 15) / 16 * 16);
+    PointerNode *newed = benchmark<PointerNode *>("new'ed", keys, probes, [](PointerNode **root, int key) {
+        BST::insert(root, key);
+    }, [&]() {return MALLOC_CHUNK * KEYS;});
+    NodePool<PointerNode> pool;
+    benchmark<PointerNode *>("pooled", keys, probes, [&pool](PointerNode **root, int key) {
+        BST::insert(root, key, pool);
+    }, [&pool]() {return pool.reservedBytes();});
+    pool.releaseAll();
+    destroyTree(benchmark<Compact::Ptr>("compact", keys, probes, [](Compact::Ptr *root, int key) {
+        BST::insert(root, key);
+    }, []() {return CompactArena<Compact>::instance().reservedBytes();}));
+    for (auto it = postorder(newed).begin(); it != PostorderIterator<PointerNode>(); ) {
+        PointerNode *node = &*it;
+        ++it;
+        delete node;
+    }
+}
@@ -0,0 +1,186 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#include "concurrent_heap.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+
+// Every thread pops until the queue runs dry. Since nothing is inserted meanwhile, a strict priority queue
+// returns key k as the k-th pop overall. The distance between a popped key and its position in the global pop
+// order (taken from a shared ticket counter right after the pop) is therefore an estimate of the rank error.
+// It also tells whether every thread saw its own pops strictly increasing, which a linearizable queue
+// guarantees: whatever a thread pops next was still in the queue during its previous pop.
+template <typename Queue>
+bool drainAndMeasureRankError(Queue &queue, int threads, ll n, double &averageError, ll &maxError) {
+    atomic<ll> ticket(0);
+    vector<ll> errorSums(threads, 0), errorMaxes(threads, 0);
+    vector<char> increasing(threads, 1);
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ll value, previous = -1;
+            while (queue.popHead(value)) {
+                ll position = ticket.fetch_add(1);
+                ll error = llabs(value - position);
+                errorSums[t] += error;
+                errorMaxes[t] = max(errorMaxes[t], error);
+                increasing[t] = increasing[t] && (previous < value);
+                previous = value;
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    ll sum = 0;
+    maxError = 0;
+    for (int t = 0; t < threads; ++t) {
+        sum += errorSums[t];
+        maxError = max(maxError, errorMaxes[t]);
+    }
+    averageError = static_cast<double>(sum) / n;
+    return (ticket == n) && all_of(increasing.begin(), increasing.end(), [](char ok) {return ok;});
+}
+
+// Each thread alternates inserts and pops. Returns millions of operations per second.
+template <typename Queue>
+double mixedThroughput(Queue &queue, int threads, ll opsPerThread) {
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ll value = 0;
+            for (ll i = 0; i < opsPerThread; i += 2) {
+                queue.insert((i * 7919 + t) % 1000003);
+                queue.popHead(value);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return (threads * opsPerThread) / elapsed.count() / 1e6;
+}
+
+template <typename Queue>
+bool popsAllInOrder(Queue &queue, ll n) {
+    ll value = 0;
+    for (ll i = 0; i < n; ++i) {
+        if (!queue.popHead(value) || value != i) {
+            return false;
+        }
+    }
+    return !queue.popHead(value);
+}
+
+int main() {
+    const ll n = 1000;
+    
+    cout << "Single threaded sanity checks:\n";
+    {
+        FineGrainedHeap<ll> strict(n);
+        for (ll i = n - 1; i >= 0; --i) {
+            strict.insert((i * 37) % n);
+        }
+        ll head = -1;
+        strict.peekHead(head);
+        cout << "FineGrainedHeap head --> " << head << endl;
+        cout << "FineGrainedHeap pops in order --> " << (popsAllInOrder(strict, n) ? "PASS" : "FAIL") << endl;
+        cout << "FineGrainedHeap rejects inserts when full --> ";
+        for (ll i = 0; i < n; ++i) {
+            strict.insert(i);
+        }
+        cout << (strict.insert(n) ? "FAIL" : "PASS") << endl;
+    }
+    {
+        MultiQueue<ll> relaxed(1, 1); // Two shards.
+        for (ll i = 0; i < n; ++i) {
+            relaxed.insert(i);
+        }
+        ll head = -1;
+        relaxed.peekHead(head);
+        cout << "MultiQueue head --> " << head << endl;
+        vector<ll> popped;
+        ll value;
+        while (relaxed.popHead(value)) {
+            popped.push_back(value);
+        }
+        sort(popped.begin(), popped.end());
+        bool allThere = (popped.size() == static_cast<size_t>(n));
+        for (ll i = 0; allThere && i < n; ++i) {
+            allThere = (popped[i] == i);
+        }
+        cout << "MultiQueue returns every element exactly once --> " << (allThere ? "PASS" : "FAIL") << endl;
+    }
+    
+    cout << "\nContention benchmark (alternating insert/pop, Mops/s) and rank error of a concurrent drain:\n";
+    cout << "threads\tstrict Mops/s\tstrict avg/max rank err\tmulti Mops/s\tmulti avg/max rank err\tstrict pops increase\n";
+    const ll prefill = 10000;
+    const ll totalOps = 40000;
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        FineGrainedHeap<ll> strict(prefill + threads);
+        MultiQueue<ll> relaxed(threads);
+        for (ll i = 0; i < prefill; ++i) {
+            strict.insert(i);
+            relaxed.insert(i);
+        }
+        double strictOps = mixedThroughput(strict, threads, totalOps / threads);
+        double relaxedOps = mixedThroughput(relaxed, threads, totalOps / threads);
+        
+        // Refill with distinct keys 0..prefill-1 for the rank error measurement.
+        ll value;
+        while (strict.popHead(value)) {}
+        while (relaxed.popHead(value)) {}
+        for (ll i = 0; i < prefill; ++i) {
+            strict.insert(i);
+            relaxed.insert(i);
+        }
+        double strictAvg, relaxedAvg;
+        ll strictMax, relaxedMax;
+        bool strictOrder = drainAndMeasureRankError(strict, threads, prefill, strictAvg, strictMax);
+        drainAndMeasureRankError(relaxed, threads, prefill, relaxedAvg, relaxedMax);
+        cout << threads << "\t" << strictOps << "\t\t" << strictAvg << " / " << strictMax
+             << "\t\t\t" << relaxedOps << "\t\t" << relaxedAvg << " / " << relaxedMax << "\t\t\t"
+             << (strictOrder ? "PASS" : "FAIL") << endl;
+    }
+
+    // Many short concurrent drains of a small prefilled heap, where pops overlap the most.
+    bool increasing = true;
+    double average;
+    ll worst;
+    for (int round = 0; round < 2000; ++round) {
+        FineGrainedHeap<ll> strict(64);
+        for (ll i = 63; i >= 0; --i) {
+            strict.insert(i);
+        }
+        increasing = increasing && drainAndMeasureRankError(strict, 4, 64, average, worst);
+    }
+    cout << "\nFineGrainedHeap drainers each pop strictly increasing keys --> " << (increasing ? "PASS" : "FAIL") << endl;
+}
@@ -0,0 +1,191 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <shared_mutex>
+#include <cstdlib>
+
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+#include "concurrent_ordered_map.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+
+// Random inserts, removes and finds from one thread, against std::map.
+bool matchesMap() {
+    ConcurrentOrderedMap<ll, ll> tree;
+    map<ll, ll> reference;
+    mt19937_64 generator(43);
+    bool same = true;
+    for (int i = 0; i < 200000; ++i) {
+        ll key = static_cast<ll>(generator() % 5000);
+        switch (generator() % 3) {
+        case 0:
+            same = same && (tree.insert(key, i) == reference.insert(make_pair(key, ll(i))).second);
+            break;
+        case 1:
+            same = same && (tree.remove(key) == (reference.erase(key) == 1));
+            break;
+        default: {
+            ll value = -1;
+            bool found = tree.find(key, value);
+            auto it = reference.find(key);
+            same = same && (found == (it != reference.end())) && (!found || (value == it->second));
+        }
+        }
+        if (!(i % 10000)) {
+            same = same && tree.isValid();
+        }
+    }
+    return same && tree.isValid() && (tree.size() == reference.size());
+}
+
+// Readers look up keys while writers keep inserting and removing others. Even keys are never removed, and
+// every value is three times its key, so a reader can tell if it sees a torn or freed node.
+bool survivesChurn(int readers, int writers, int milliseconds) {
+    ConcurrentOrderedMap<ll, ll> tree;
+    const ll KEYS = 20000;
+    for (ll key = 0; key < KEYS; key += 2) {
+        tree.insert(key, 3 * key);
+    }
+    atomic<bool> stop(false);
+    atomic<bool> ok(true);
+    vector<thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            mt19937_64 generator(w);
+            while (!stop.load(memory_order_relaxed)) {
+                ll key = 2 * static_cast<ll>(generator() % (KEYS / 2)) + 1;
+                if (generator() & 1) {
+                    tree.insert(key, 3 * key);
+                } else {
+                    tree.remove(key);
+                }
+            }
+        });
+    }
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            mt19937_64 generator(100 + r);
+            while (!stop.load(memory_order_relaxed)) {
+                ll key = static_cast<ll>(generator() % KEYS);
+                ll value = -1;
+                bool found = tree.find(key, value);
+                if ( (!(key & 1) && !found) || (found && (value != 3 * key)) ) {
+                    ok.store(false);
+                }
+            }
+        });
+    }
+    this_thread::sleep_for(chrono::milliseconds(milliseconds));
+    stop.store(true);
+    for (auto &t : threads) {
+        t.join();
+    }
+    return ok.load() && tree.isValid();
+}
+
+// Operations per second over a fixed time, with the given share of reads, from threads threads.
+template <typename Read, typename Write>
+double throughput(int threads, int readPercent, int milliseconds, ll keys, Read read, Write write) {
+    atomic<bool> stop(false);
+    atomic<long long> operations(0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            mt19937_64 generator(t);
+            long long done = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                ll key = static_cast<ll>(generator() % keys);
+                if (static_cast<int>(generator() % 100) < readPercent) {
+                    read(key);
+                } else {
+                    write(key, generator() & 1);
+                }
+                ++done;
+            }
+            operations.fetch_add(done);
+        });
+    }
+    this_thread::sleep_for(chrono::milliseconds(milliseconds));
+    stop.store(true);
+    for (auto &w : workers) {
+        w.join();
+    }
+    return operations.load() * 1000.0 / milliseconds;
+}
+
+int main(int argc, char **argv) {
+    ConcurrentOrderedMap<ll, ll> tree;
+    for (ll key : {50, 20, 80, 10, 30}) {
+        tree.insert(key, key * 10);
+    }
+    ll value = 0;
+    bool basics = !tree.insert(20, 7) && tree.find(20, value) && (value == 200) && !tree.find(25, value) &&
+                  tree.remove(20) && !tree.remove(20) && !tree.contains(20) && (tree.size() == 4) && tree.isValid();
+    cout << "insert, find, remove --> " << (basics ? "PASS" : "FAIL") << endl;
+    cout << "Random operations match std::map --> " << (matchesMap() ? "PASS" : "FAIL") << endl;
+    cout << "Readers during inserts and removes --> " << (survivesChurn(4, 2, 500) ? "PASS" : "FAIL") << endl;
+
+    // 99% reads on a million keys, against RBTree behind a reader-writer lock. Pass the longest run in
+    // milliseconds per point; the default is short.
+    const int MS = (argc > 1) ? atoi(argv[1]) : 200;
+    const ll KEYS = 1000000;
+    ConcurrentOrderedMap<ll, ll> concurrent;
+    RBTree<ll> *locked = nullptr;
+    shared_timed_mutex lock;
+    for (ll key = 0; key < KEYS; key += 2) {
+        concurrent.insert(key, key);
+        RB::insert(&locked, key);
+    }
+    cout << "\nthreads\tlock-free reads Mops/s\treader-writer lock Mops/s\n";
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        double free = throughput(threads, 99, MS, KEYS, [&](ll key) {
+            ll v;
+            concurrent.find(key, v);
+        }, [&](ll key, bool add) {
+            if (add) {
+                concurrent.insert(key, key);
+            } else {
+                concurrent.remove(key);
+            }
+        });
+        double shared = throughput(threads, 99, MS, KEYS, [&](ll key) {
+            shared_lock<shared_timed_mutex> guard(lock);
+            BST::find(locked, key);
+        }, [&](ll key, bool add) {
+            unique_lock<shared_timed_mutex> guard(lock);
+            if (add) {
+                RB::insert(&locked, key);
+            } else {
+                RB::remove(&locked, key);
+            }
+        });
+        cout << threads << "\t" << free / 1e6 << "\t\t\t" << shared / 1e6 << endl;
+    }
+    delete locked;
+}
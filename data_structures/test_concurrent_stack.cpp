@@ -0,0 +1,129 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "stack.h"
+#include "concurrent_stack.h"
+
+using namespace std;
+
+typedef long long ll;
+
+// Every thread pushes its own range of values and pops whatever it finds, then the main thread drains the
+// rest. Each value has to come out exactly once.
+bool stressTest(int threads, ll perThread) {
+	vvalgo::ConcurrentStack<ll> stack;
+	vector<vector<ll> > popped(threads);
+	vector<thread> workers;
+	for (int t = 0; t < threads; ++t) {
+		workers.emplace_back([&, t]() {
+			ll item;
+			for (ll i = 0; i < perThread; ++i) {
+				stack.push(t * perThread + i);
+				if ( (i % 3 != 0) && stack.pop(item) ) {
+					popped[t].push_back(item);
+				}
+			}
+		});
+	}
+	for (auto &w : workers) {
+		w.join();
+	}
+	vector<ll> all;
+	for (auto &p : popped) {
+		all.insert(all.end(), p.begin(), p.end());
+	}
+	ll item;
+	while (stack.pop(item)) {
+		all.push_back(item);
+	}
+	sort(all.begin(), all.end());
+	if (all.size() != static_cast<size_t>(threads * perThread)) {
+		return false;
+	}
+	for (ll i = 0; i < threads * perThread; ++i) {
+		if (all[i] != i) {
+			return false;
+		}
+	}
+	return stack.is_empty();
+}
+
+// Each thread does push/pop pairs. Returns millions of operations per second.
+template <typename Push, typename Pop>
+double throughput(int threads, ll opsPerThread, Push push, Pop pop) {
+	auto start = chrono::steady_clock::now();
+	vector<thread> workers;
+	for (int t = 0; t < threads; ++t) {
+		workers.emplace_back([&, t]() {
+			for (ll i = 0; i < opsPerThread; i += 2) {
+				push(i + t);
+				pop();
+			}
+		});
+	}
+	for (auto &w : workers) {
+		w.join();
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+	return (threads * opsPerThread) / elapsed.count() / 1e6;
+}
+
+int main() {
+	vvalgo::ConcurrentStack<int> st;
+	st.push(25);
+	st.push(100);
+
+	int i = 0;
+	st.peek(i);
+	cout << "peek --> " << i << endl;
+	st.pop(i);
+	cout << i << endl;
+	st.pop(i);
+	cout << i << endl;
+	cout << "empty --> " << (st.is_empty() ? "yes" : "no") << ", pop on empty --> " << (st.pop(i) ? "true" : "false") << endl;
+
+	cout << "\nStress test (every pushed value popped exactly once):\n";
+	for (int threads = 1; threads <= 16; threads *= 2) {
+		cout << threads << " threads --> " << (stressTest(threads, 200000 / threads) ? "PASS" : "FAIL") << endl;
+	}
+
+	cout << "\nThroughput of push/pop pairs (Mops/s):\n";
+	cout << "threads\tlock-free\tmutex + vvalgo::Stack\n";
+	const ll totalOps = 2000000;
+	for (int threads = 1; threads <= 64; threads *= 2) {
+		vvalgo::ConcurrentStack<ll> lockFree;
+		vvalgo::Stack<ll> locked;
+		mutex lock;
+		ll sink = 0;
+		double lockFreeOps = throughput(threads, totalOps / threads,
+		                                [&](ll item) {lockFree.push(item);},
+		                                [&]() {ll item; lockFree.pop(item);});
+		double lockedOps = throughput(threads, totalOps / threads,
+		                              [&](ll item) {lock_guard<mutex> guard(lock); locked.push(item);},
+		                              [&]() {lock_guard<mutex> guard(lock); locked.pop(sink);});
+		cout << threads << "\t" << lockFreeOps << "\t\t" << lockedOps << endl;
+	}
+}
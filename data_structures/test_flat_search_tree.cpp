@@ -0,0 +1,141 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+#include "flat_search_tree.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+typedef RBTree<ll> Node;
+
+typedef chrono::duration<double, milli> Ms;
+
+// lowerBound() and find() agree with std::lower_bound over sorted at every value and between them.
+bool agrees(const FlatSearchTree<ll> &flat, const vector<ll> &sorted) {
+    if ( (flat.size() != sorted.size()) || !flat.isValid() ) {
+        return false;
+    }
+    for (size_t i = 0; i <= sorted.size(); ++i) {
+        for (ll probe : {i < sorted.size() ? sorted[i] : 1000000000LL, i < sorted.size() ? sorted[i] - 1 : -1000000000LL}) {
+            auto expected = lower_bound(sorted.begin(), sorted.end(), probe);
+            const ll *bound = flat.lowerBound(probe);
+            const ll *found = flat.find(probe);
+            bool there = (expected != sorted.end()) && (*expected == probe);
+            if ( ((bound != nullptr) != (expected != sorted.end())) || (bound && (*bound != *expected)) ||
+                 ((found != nullptr) != there) || (found && (*found != probe)) ) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    // Every size up to a few hundred, from balanced trees, and random trees with repeats from plain BST inserts.
+    mt19937_64 generator(49);
+    bool same = true;
+    for (ll n = 0; n < 300; ++n) {
+        vector<ll> sorted;
+        for (ll i = 0; i < n; ++i) {
+            sorted.push_back(3 * i);
+        }
+        Node *root = nullptr;
+        RB::build(&root, sorted.begin(), sorted.end());
+        same = same && agrees(FlatSearchTree<ll>(root), sorted);
+        delete root;
+        root = nullptr;
+        sorted.clear();
+        for (ll i = 0; i < n; ++i) {
+            ll value = static_cast<ll>(generator() % 100);
+            BST::insert(&root, value);
+            sorted.push_back(value);
+        }
+        sort(sorted.begin(), sorted.end());
+        same = same && agrees(FlatSearchTree<ll>(root), sorted);
+        delete root;
+    }
+    cout << "Lookups match std::lower_bound --> " << (same ? "PASS" : "FAIL") << endl;
+
+    vector<ll> few = {5, 10, 15, 20};
+    Node *root = nullptr;
+    RB::build(&root, few.begin(), few.end());
+    FlatSearchTree<ll> original(root);
+    delete root;
+    FlatSearchTree<ll> copy(original), moved(std::move(original)), assigned;
+    assigned = copy;
+    bool copies = agrees(copy, few) && agrees(moved, few) && agrees(assigned, few) && original.isEmpty() &&
+                  !original.find(5);
+    cout << "Copies and moves --> " << (copies ? "PASS" : "FAIL") << endl;
+
+    // Random keys inserted in random order, so the nodes are scattered as in a long-lived tree, then random
+    // lookups, half of them misses. Against the pointer tree and a binary search of the sorted keys. Pass the
+    // number of keys; the default is 4M.
+    const size_t N = (argc > 1) ? static_cast<size_t>(atoll(argv[1])) : 4000000;
+    vector<ll> keys(N);
+    for (ll &key : keys) {
+        key = static_cast<ll>(generator() >> 1);
+    }
+    root = nullptr;
+    for (ll key : keys) {
+        RB::insert(&root, key);
+    }
+    auto start = chrono::steady_clock::now();
+    FlatSearchTree<ll> flat(root);
+    Ms freezeMs = chrono::steady_clock::now() - start;
+    vector<ll> sorted(keys);
+    sort(sorted.begin(), sorted.end());
+    sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+    const size_t LOOKUPS = 4000000;
+    vector<ll> probes(LOOKUPS);
+    for (ll &probe : probes) {
+        probe = (generator() & 1) ? keys[generator() % N] : static_cast<ll>(generator() >> 1);
+    }
+    size_t hits[3] = {0, 0, 0};
+    start = chrono::steady_clock::now();
+    for (ll probe : probes) {
+        hits[0] += (BST::find(root, probe) != nullptr);
+    }
+    Ms treeMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    for (ll probe : probes) {
+        hits[1] += flat.contains(probe);
+    }
+    Ms flatMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    for (ll probe : probes) {
+        hits[2] += binary_search(sorted.begin(), sorted.end(), probe);
+    }
+    Ms sortedMs = chrono::steady_clock::now() - start;
+    cout << "\n" << flat.size() << " keys, frozen in " << freezeMs.count() << " ms. ns per lookup:\n";
+    cout << "RB tree\tflat\tsorted array\n";
+    cout << treeMs.count() * 1e6 / LOOKUPS << "\t" << flatMs.count() * 1e6 / LOOKUPS << "\t"
+         << sortedMs.count() * 1e6 / LOOKUPS << "\t\t"
+         << ( (hits[0] == hits[1]) && (hits[1] == hits[2]) ? "PASS" : "FAIL" ) << endl;
+    delete root;
+}
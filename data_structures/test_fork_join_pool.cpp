@@ -0,0 +1,84 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <numeric>
+
+#include "fork_join_pool.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+
+// Recursive sum that forks both halves until the range is small enough to add up directly.
+template <typename T>
+ll parallelSum(ForkJoinPool &pool, T b, T e, ll cutoff) {
+    if (e - b <= cutoff) {
+        return accumulate(b, e, 0LL);
+    }
+    T mid = b + (e - b) / 2;
+    ll left = 0, right = 0;
+    pool.invoke([&]() {left = parallelSum(pool, b, mid, cutoff);},
+                [&]() {right = parallelSum(pool, mid, e, cutoff);});
+    return left + right;
+}
+
+// Deliberately naive so that the work per task is compute bound rather than memory bound.
+ll fibonacci(ForkJoinPool &pool, int n) {
+    if (n < 2) {
+        return n;
+    }
+    if (n < 20) {
+        return fibonacci(pool, n - 1) + fibonacci(pool, n - 2);
+    }
+    ll a = 0, b = 0;
+    pool.invoke([&]() {a = fibonacci(pool, n - 1);}, [&]() {b = fibonacci(pool, n - 2);});
+    return a + b;
+}
+
+int main() {
+    vector<ll> v(1 << 24);
+    iota(v.begin(), v.end(), 1);
+    const ll expected = static_cast<ll>(v.size()) * (v.size() + 1) / 2;
+    
+    cout << "threads\tsum ms\tspeedup\tfib(32) ms\tspeedup\tcorrect\n";
+    double sumBase = 0, fibBase = 0;
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        ForkJoinPool pool(threads);
+        ll sum = 0, fib = 0;
+        
+        auto start = chrono::steady_clock::now();
+        pool.run([&]() {sum = parallelSum(pool, v.begin(), v.end(), 1 << 14);});
+        chrono::duration<double, milli> sumMs = chrono::steady_clock::now() - start;
+        
+        start = chrono::steady_clock::now();
+        fib = fibonacci(pool, 32); // invoke() from outside the pool goes through run() by itself.
+        chrono::duration<double, milli> fibMs = chrono::steady_clock::now() - start;
+        
+        if (threads == 1) {
+            sumBase = sumMs.count();
+            fibBase = fibMs.count();
+        }
+        cout << threads << "\t" << sumMs.count() << "\t" << sumBase / sumMs.count()
+             << "\t" << fibMs.count() << "\t\t" << fibBase / fibMs.count()
+             << "\t" << (((sum == expected) && (fib == 2178309)) ? "PASS" : "FAIL") << endl;
+    }
+}
@@ -20,6 +20,7 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <algorithm>
 
 #include "heap.h"
 
@@ -111,4 +112,30 @@ int main () {
     leap.sort();
     printAll(begin(leap), end(leap));
     
+    // HeapView works inside the caller's buffer without copying it.
+    long buffer[16] = { 99, 89, 79, 69, 59, 49, 39, 29, 19, 9};
+    HeapView<long *> view(buffer, buffer + 10, buffer + 16);
+    cout << "Heap view created over a plain array (capacity " << view.capacity() << ") :\n";
+    printAll(begin(view), end(view));
+    view.insert(5);
+    view.insert(1000);
+    cout << "Heap view after inserting 5 and 1000 :\n";
+    printAll(begin(view), end(view));
+    view.peekHead(head);
+    cout << "head of the heap view --> " << head << endl;
+    view.popHead();
+    view.peekHead(head);
+    cout << "head of the heap view after a pop --> " << head << endl;
+    view.sort();
+    cout << "Heap view after sorting :\n";
+    printAll(begin(view), end(view));
+    cout << (is_sorted(begin(view), end(view)) ? "SORTED" : "UNSORTED") << endl;
+    
+    // Max-heap sort of a vector in place using the free heap algorithms.
+    vector<long> w = { 3, 14, 15, 92, 65, 35, 89, 79, 32, 38};
+    heap::buildHeap(begin(w), end(w), greater<long>());
+    heap::sortHeap(begin(w), end(w), greater<long>());
+    cout << "In-place heap sort of a vector using a max-heap :\n";
+    printAll(begin(w), end(w));
+    cout << (is_sorted(begin(w), end(w)) ? "SORTED" : "UNSORTED") << endl;
 }
@@ -0,0 +1,147 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#include "tree_traversal.h"
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+#include "interval_tree.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+typedef IntervalTree<ll> Node;
+typedef Interval<ll> Span;
+
+typedef chrono::duration<double, milli> Ms;
+
+// The overlapping intervals, sorted, by a query and by brute force over reference.
+vector<Span> query(Node *root, ll low, ll high) {
+    vector<Span> found;
+    IT::overlapping(root, low, high, [&found](Node *node) {found.push_back(node->value); return false;});
+    sort(found.begin(), found.end());
+    return found;
+}
+
+vector<Span> bruteForce(const set<Span> &reference, ll low, ll high) {
+    vector<Span> found;
+    for (const Span &span : reference) {
+        if (span.overlaps(low, high)) {
+            found.push_back(span);
+        }
+    }
+    return found;
+}
+
+int main(int argc, char **argv) {
+    Node *root = nullptr;
+    for (Span span : {Span{15, 23}, Span{8, 9}, Span{25, 30}, Span{5, 8}, Span{16, 21}, Span{0, 3}, Span{6, 10},
+                      Span{17, 19}, Span{26, 26}, Span{19, 20}}) {
+        RB::insert(&root, span);
+    }
+    cout << "Intervals overlapping [9, 16]: -> ";
+    for (const Span &span : query(root, 9, 16)) {
+        cout << "[" << span.low << ", " << span.high << "] ";
+    }
+    Node *any = IT::anyOverlapping(root, 22, 25);
+    cout << "\nSome interval overlapping [22, 25]: [" << any->value.low << ", " << any->value.high << "]" << endl;
+    bool basics = (query(root, 9, 16).size() == 4) && query(root, 11, 14).empty() &&
+                  !IT::anyOverlapping(root, 11, 14) && (query(root, 26, 26).size() == 2) && IT::isValid(root);
+    cout << "Small queries --> " << (basics ? "PASS" : "FAIL") << endl;
+    delete root;
+
+    // Random inserts and removes against brute force over std::set, with the augmentation checked as we go.
+    mt19937_64 generator(47);
+    set<Span> reference;
+    root = nullptr;
+    bool same = true;
+    for (int i = 0; i < 50000; ++i) {
+        ll low = static_cast<ll>(generator() % 10000);
+        Span span{low, low + static_cast<ll>(generator() % 300)};
+        if (generator() % 3) {
+            RB::insert(&root, span);
+            reference.insert(span);
+        } else {
+            same = same && (RB::remove(&root, span) == (reference.erase(span) == 1));
+        }
+        if (!(i % 500)) {
+            ll from = static_cast<ll>(generator() % 10000);
+            ll to = from + static_cast<ll>(generator() % 100);
+            Node *some = IT::anyOverlapping(root, from, to);
+            vector<Span> expected = bruteForce(reference, from, to);
+            same = same && (query(root, from, to) == expected) && ((some != nullptr) == !expected.empty()) &&
+                   (!some || some->value.overlaps(from, to)) && RB::isValid(root) && IT::isValid(root);
+        }
+    }
+    delete root;
+    cout << "Random updates and queries match brute force --> " << (same ? "PASS" : "FAIL") << endl;
+
+    // Time ranges: N intervals up to a minute long, spread over a year of seconds, bulk built. Queries for
+    // one-second points and ten-minute windows, against a scan of every node. Pass N; the default is 1M.
+    const ll N = (argc > 1) ? atoll(argv[1]) : 1000000;
+    const ll YEAR = 365LL * 24 * 3600 * 1000;   // In milliseconds.
+    vector<Span> spans(N);
+    for (Span &span : spans) {
+        span.low = static_cast<ll>(generator() % YEAR);
+        span.high = span.low + static_cast<ll>(generator() % 60000);
+    }
+    sort(spans.begin(), spans.end());
+    root = nullptr;
+    auto start = chrono::steady_clock::now();
+    RB::build(&root, spans.begin(), spans.end());
+    Ms buildMs = chrono::steady_clock::now() - start;
+    cout << "\n" << N << " intervals built in " << buildMs.count() << " ms, valid --> "
+         << (IT::isValid(root) && RB::isValid(root) ? "PASS" : "FAIL") << endl;
+    cout << "query\t\tqueries\tfound\tindexed ms/query\tscan ms/query\n";
+    for (ll width : {1000LL, 600000LL}) {
+        const int QUERIES = 10000, SCANS = 5;
+        vector<ll> lows(QUERIES);
+        for (ll &low : lows) {
+            low = static_cast<ll>(generator() % YEAR);
+        }
+        size_t found = 0;
+        start = chrono::steady_clock::now();
+        for (ll low : lows) {
+            IT::overlapping(root, low, low + width, [&found](Node *) {++found; return false;});
+        }
+        Ms indexedMs = chrono::steady_clock::now() - start;
+        size_t scanned = 0, indexed = 0;
+        start = chrono::steady_clock::now();
+        for (int q = 0; q < SCANS; ++q) {
+            ll low = lows[q], high = low + width;
+            inorderTraverse(root, [&scanned, low, high](Node *node) {
+                scanned += node->value.overlaps(low, high);
+                return false;
+            });
+            IT::overlapping(root, low, high, [&indexed](Node *) {++indexed; return false;});
+        }
+        Ms scanMs = chrono::steady_clock::now() - start;
+        cout << ((width == 1000) ? "1 s point" : "10 min window") << "\t" << QUERIES << "\t" << found << "\t"
+             << indexedMs.count() / QUERIES << "\t\t" << scanMs.count() / SCANS << "\t\t"
+             << ((scanned == indexed) ? "PASS" : "FAIL") << endl;
+    }
+    delete root;
+}
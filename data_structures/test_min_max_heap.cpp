@@ -0,0 +1,95 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "min_max_heap.h"
+
+using namespace std;
+using namespace vvalgo;
+
+template <typename T>
+void printAll(T b, T e) {
+	cout << "************************************************\n";
+	for (T i = b; i != e; ++i) {
+		cout << *i << " ";
+	}
+	cout << "\n************************************************\n";
+}
+
+int main() {
+    vector<long> v = { 99, 89, 79, 69, 59, 49, 39, 29, 19, 9};
+    MinMaxHeap<long> heap;
+    for (auto x : v) {
+        heap.insert(x);
+    }
+    cout << "Min-max heap created from the array :\n";
+    printAll(begin(heap), end(heap));
+    
+    long min = 0, max = 0;
+    heap.peekMin(min);
+    heap.peekMax(max);
+    cout << "min --> " << min << ", max --> " << max << endl;
+    heap.popMin();
+    heap.popMax();
+    heap.peekMin(min);
+    heap.peekMax(max);
+    cout << "After popping both ends: min --> " << min << ", max --> " << max << endl;
+    
+    // Bounded buffer of the 5 smallest elements seen so far: evict the max whenever we grow past 5.
+    MinMaxHeap<long> bounded;
+    for (long i = 0; i < 100; ++i) {
+        bounded.insert((i * 37) % 101);
+        if (bounded.size() > 5) {
+            bounded.popMax();
+        }
+    }
+    cout << "Five smallest of the stream (expect 0 1 2 3 4) :\n";
+    while (!bounded.isEmpty()) {
+        bounded.peekMin(min);
+        bounded.popMin();
+        cout << min << " ";
+    }
+    cout << endl;
+    
+    // Randomised check against a sorted vector, popping from alternating ends.
+    MinMaxHeap<long> checked;
+    vector<long> sorted;
+    for (long i = 0; i < 5000; ++i) {
+        sorted.push_back((i * 7919) % 4099);
+        checked.insert(sorted.back());
+    }
+    sort(sorted.begin(), sorted.end());
+    auto lo = sorted.begin();
+    auto hi = sorted.end();
+    bool ok = true;
+    for (long i = 0; lo != hi; ++i) {
+        if (i % 3 == 0) {
+            checked.peekMax(max);
+            checked.popMax();
+            ok = ok && (max == *(--hi));
+        } else {
+            checked.peekMin(min);
+            checked.popMin();
+            ok = ok && (min == *(lo++));
+        }
+    }
+    cout << "Alternating pops from both ends match the sorted order --> " << ((ok && checked.isEmpty()) ? "PASS" : "FAIL") << endl;
+}
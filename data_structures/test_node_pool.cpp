@@ -0,0 +1,191 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <new>
+#ifdef __GLIBC__
+#include <malloc.h> // malloc_usable_size
+#endif
+
+#include "binary_tree.h"
+#include "node_pool.h"
+
+// Count every heap allocation the program makes, and how many bytes malloc really sets aside for them.
+static size_t allocations = 0;
+static size_t allocatedBytes = 0;
+
+// The replacements are kept out of line: once one is inlined, GCC sees its malloc() or free() paired with an
+// operator delete or new and warns about a mismatch.
+#ifdef __GNUC__
+#define OUT_OF_LINE __attribute__((noinline))
+#else
+#define OUT_OF_LINE
+#endif
+
+OUT_OF_LINE void *operator new(size_t size) {
+    void *memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    ++allocations;
+#ifdef __GLIBC__
+    allocatedBytes += malloc_usable_size(memory) + sizeof(size_t); // Plus the chunk header.
+#else
+    allocatedBytes += size;
+#endif
+    return memory;
+}
+
+OUT_OF_LINE void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+// Sized delete (C++14), which the standard containers use.
+OUT_OF_LINE void operator delete(void *memory, std::size_t) noexcept {
+    ::operator delete(memory);
+}
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+typedef BinaryTree<ll> Tree;
+
+// Plain BST insertion. Creating the node is up to the caller.
+template <typename Create>
+void insert(Tree **root, ll value, Create create) {
+    while (*root) {
+        root = (value < (*root)->value) ? &(*root)->lChild : &(*root)->rChild;
+    }
+    *root = create(value);
+}
+
+ll sum(Tree *root) {
+    ll total = 0;
+    for (auto &node : inorder(root)) {
+        total += node.value;
+    }
+    return total;
+}
+
+typedef chrono::duration<double, milli> Ms;
+
+int main() {
+    const int NODES = 1 << 20;
+    mt19937_64 generator(3);
+    vector<ll> keys(NODES);
+    for (auto &key : keys) {
+        key = static_cast<ll>(generator() % 1000000000);
+    }
+
+    cout << "Building a random BST of " << NODES << " nodes of " << sizeof(Tree) << " bytes\n";
+    cout << "nodes from\tallocations\tbytes/node\tbuild ms\twalk ms\tdestroy ms\n";
+
+    // One new per node, torn down by the destructor.
+    size_t allocationsBefore = allocations, bytesBefore = allocatedBytes;
+    auto start = chrono::steady_clock::now();
+    Tree *root = nullptr;
+    for (ll key : keys) {
+        insert(&root, key, [](ll value) {return new Tree{value};});
+    }
+    Ms buildMs = chrono::steady_clock::now() - start;
+    size_t newAllocations = allocations - allocationsBefore;
+    double newBytes = double(allocatedBytes - bytesBefore) / NODES;
+    start = chrono::steady_clock::now();
+    const ll expected = sum(root);
+    Ms walkMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    delete root;
+    Ms destroyMs = chrono::steady_clock::now() - start;
+    cout << "new\t\t" << newAllocations << "\t\t" << newBytes << "\t\t" << buildMs.count() << "\t\t"
+         << walkMs.count() << "\t" << destroyMs.count() << endl;
+
+    // A pool, torn down node by node and then all at once.
+    for (int bulk = 0; bulk < 2; ++bulk) {
+        allocationsBefore = allocations;
+        NodePool<Tree> pool;
+        start = chrono::steady_clock::now();
+        root = nullptr;
+        for (ll key : keys) {
+            insert(&root, key, [&pool](ll value) {return pool.create(value);});
+        }
+        buildMs = chrono::steady_clock::now() - start;
+        size_t poolAllocations = allocations - allocationsBefore;
+        double poolBytes = double(pool.reservedBytes()) / NODES;
+        start = chrono::steady_clock::now();
+        bool same = (sum(root) == expected);
+        walkMs = chrono::steady_clock::now() - start;
+        start = chrono::steady_clock::now();
+        if (bulk) {
+            pool.releaseAll();
+        } else {
+            pool.destroyTree(root);
+        }
+        destroyMs = chrono::steady_clock::now() - start;
+        cout << (bulk ? "pool, releaseAll" : "pool, destroyTree") << "\t" << poolAllocations << "\t\t"
+             << poolBytes << "\t\t" << buildMs.count() << "\t\t" << walkMs.count() << "\t" << destroyMs.count()
+             << "\t" << ((same && !pool.size()) ? "PASS" : "FAIL") << endl;
+    }
+
+    // A pool reuses what it has: the second tree costs no allocations at all.
+    NodePool<Tree, 256> pool;
+    root = nullptr;
+    for (int i = 0; i < 10000; ++i) {
+        insert(&root, keys[i], [&pool](ll value) {return pool.create(value);});
+    }
+    pool.destroyTree(root);
+    size_t slabs = pool.slabsAllocated();
+    allocationsBefore = allocations;
+    root = nullptr;
+    for (int i = 0; i < 10000; ++i) {
+        insert(&root, keys[i], [&pool](ll value) {return pool.create(value);});
+    }
+    pool.releaseAll();
+    for (int i = 0; i < 10000; ++i) {
+        pool.create(keys[i]);
+    }
+    cout << "Rebuilding from the free list and after releaseAll() allocates nothing --> "
+         << (((allocations == allocationsBefore) && (pool.slabsAllocated() == slabs)) ? "PASS" : "FAIL") << endl;
+    pool.releaseAll();
+
+    // Values with destructors go through destroyTree() (releaseAll() would not compile).
+    NodePool<BinaryTree<string> > strings;
+    BinaryTree<string> *names = strings.create(string(40, 'm'));
+    names->lChild = strings.create(string(40, 'f'));
+    names->rChild = strings.create(string(40, 't'));
+    names->lChild->rChild = strings.create(string(40, 'h'));
+    strings.destroyTree(names);
+    cout << "Strings destroyed through the pool --> " << (strings.size() ? "FAIL" : "PASS") << endl;
+
+    // Sorted input makes a BST as deep as it is large. The destructor copes with that now.
+    root = nullptr;
+    Tree **last = &root;
+    for (ll i = 0; i < NODES; ++i) {
+        *last = new Tree{i};
+        last = &(*last)->rChild;
+    }
+    start = chrono::steady_clock::now();
+    delete root;
+    destroyMs = chrono::steady_clock::now() - start;
+    cout << "Deleted a " << NODES << " deep tree in " << destroyMs.count() << " ms --> PASS" << endl;
+}
@@ -0,0 +1,183 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>  // random_select.h needs it, but does not include it
+
+#include "tree_traversal.h"
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+#include "order_statistic_tree.h"
+#include "../misc/random_select.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef OrderStatisticTree<int> Node;
+
+typedef chrono::duration<double, milli> Ms;
+
+// select() and rank() agree with the sorted contents of reference at a few random ranks.
+bool ranksMatch(Node *root, const multiset<int> &reference, mt19937 &generator) {
+    vector<int> sorted(reference.begin(), reference.end());
+    if ( (OS::size(root) != sorted.size()) || OS::select(root, sorted.size()) ) {
+        return false;
+    }
+    for (int i = 0; i < 50 && !sorted.empty(); ++i) {
+        size_t k = generator() % sorted.size();
+        Node *node = OS::select(root, k);
+        size_t first = lower_bound(sorted.begin(), sorted.end(), sorted[k]) - sorted.begin();
+        if ( !node || (node->value != sorted[k]) || (OS::rank(root, sorted[k]) != first) ||
+             (OS::rankOf(node) != k) ) {
+            return false;
+        }
+        int missing = sorted[k] + 1; // Maybe not missing, but rank() counts the same either way.
+        if (OS::rank(root, missing) != size_t(lower_bound(sorted.begin(), sorted.end(), missing) - sorted.begin())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Random inserts and removes through insert() and remove(), checking sizes and ranks against reference.
+template <typename Insert, typename Remove, typename Release>
+bool randomOperations(Insert insert, Remove remove, Release release, bool isSet, int valueRange) {
+    mt19937 generator(valueRange);
+    Node *root = nullptr;
+    multiset<int> reference;
+    bool same = true;
+    for (int i = 0; i < 100000; ++i) {
+        int value = static_cast<int>(generator() % valueRange);
+        if (generator() % 3) {
+            insert(&root, value);
+            if (!isSet || !reference.count(value)) {
+                reference.insert(value);
+            }
+        } else {
+            remove(&root, value);
+            if (reference.count(value)) {
+                reference.erase(reference.find(value));
+            }
+        }
+        if (!(i % 5000)) {
+            same = same && OS::isValid(root) && ranksMatch(root, reference, generator);
+        }
+    }
+    same = same && OS::isValid(root) && ranksMatch(root, reference, generator);
+    release(root);
+    return same;
+}
+
+int main() {
+    Node *root = nullptr;
+    for (int value : {50, 20, 80, 10, 30, 70, 90, 60}) {
+        RB::insert(&root, value);
+    }
+    cout << "Inorder with ranks: -> ";
+    for (auto &node : inorder(root)) {
+        cout << node.value << "@" << OS::rankOf(&node) << " ";
+    }
+    cout << endl;
+    bool basics = (OS::select(root, 0)->value == 10) && (OS::select(root, 7)->value == 90) && !OS::select(root, 8) &&
+                  (OS::rank(root, 60) == 4) && (OS::rank(root, 65) == 5) && (OS::rank(root, 5) == 0) &&
+                  (OS::rank(root, 100) == 8) && OS::isValid(root) && RB::isValid(root);
+    RB::remove(&root, 50);
+    basics = basics && (OS::select(root, 3)->value == 60) && (OS::size(root) == 7) && OS::isValid(root);
+    cout << "select and rank --> " << (basics ? "PASS" : "FAIL") << endl;
+    delete root;
+
+    auto release = [](Node *r) {delete r;};
+    bool rb = randomOperations([](Node **r, int v) {RB::insert(r, v);},
+                               [](Node **r, int v) {RB::remove(r, v);}, release, true, 20000);
+    cout << "Sizes through RB::insert, RB::remove and rotations --> " << (rb ? "PASS" : "FAIL") << endl;
+    bool bst = randomOperations([](Node **r, int v) {BST::insert(r, v);},
+                                [](Node **r, int v) {BST::remove(r, v);}, release, false, 2000);
+    cout << "Sizes through BST::insert and BST::remove, with duplicates --> " << (bst ? "PASS" : "FAIL") << endl;
+    NodePool<Node> pool;
+    bool pooled = randomOperations([&pool](Node **r, int v) {RB::insert(r, v, pool);},
+                                   [&pool](Node **r, int v) {RB::remove(r, v, pool);},
+                                   [&pool](Node *r) {pool.destroyTree(r);}, true, 20000);
+    pooled = pooled && !pool.size();
+    cout << "Sizes with pooled nodes --> " << (pooled ? "PASS" : "FAIL") << endl;
+
+    // select() gives the same answers as dumping the tree and running selectKthSmallest().
+    mt19937 generator(41);
+    root = nullptr;
+    for (int i = 0; i < 1000; ++i) {
+        RB::insert(&root, static_cast<int>(generator() % 100000));
+    }
+    bool agrees = true;
+    for (int i = 0; i < 100; ++i) {
+        vector<int> values;
+        for (auto &node : inorder(root)) {
+            values.push_back(node.value);
+        }
+        shuffle(values.begin(), values.end(), generator);
+        size_t k = generator() % values.size();
+        agrees = agrees && (*selectKthSmallest(values.begin(), values.end(), k) == OS::select(root, k)->value);
+    }
+    cout << "select agrees with selectKthSmallest --> " << (agrees ? "PASS" : "FAIL") << endl;
+    delete root;
+
+    // A live leaderboard: scores change while rank queries come in. Compare with dumping the tree and selecting
+    // from the copy for each query, which we can only afford a few times. That uses std::nth_element, since
+    // selectKthSmallest() picks nearly the same pivot position on every call and goes quadratic on large input.
+    const int SCORES = 1000000;
+    root = nullptr;
+    for (int i = 0; i < SCORES; ++i) {
+        RB::insert(&root, static_cast<int>(generator() & 0x7FFFFFFF));
+    }
+    const int QUERIES = 1000000;
+    auto start = chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (int i = 0; i < QUERIES; ++i) {
+        if (!(i % 10)) {    // One update for every ten queries.
+            RB::remove(&root, OS::select(root, generator() % OS::size(root))->value);
+            RB::insert(&root, static_cast<int>(generator() & 0x7FFFFFFF));
+        }
+        checksum += OS::rank(root, static_cast<int>(generator() & 0x7FFFFFFF));
+        checksum += OS::select(root, generator() % OS::size(root))->value & 1;
+    }
+    Ms treeMs = chrono::steady_clock::now() - start;
+
+    const int SLOW_QUERIES = 20;
+    int matched = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < SLOW_QUERIES; ++i) {
+        vector<int> values;
+        values.reserve(OS::size(root));
+        for (auto &node : inorder(root)) {
+            values.push_back(node.value);
+        }
+        size_t k = generator() % values.size();
+        nth_element(values.begin(), values.begin() + k, values.end());
+        matched += (values[k] == OS::select(root, k)->value);
+    }
+    Ms dumpMs = chrono::steady_clock::now() - start;
+    bool fast = OS::isValid(root) && RB::isValid(root) && checksum && (matched == SLOW_QUERIES);
+    cout << "\n" << SCORES << " scores, 10% updates\n";
+    cout << "select + rank in the tree: " << 2 * QUERIES / (treeMs.count() / 1000) << " queries/s\n";
+    cout << "dump + nth_element:         " << SLOW_QUERIES / (dumpMs.count() / 1000) << " queries/s\n";
+    cout << "Leaderboard --> " << (fast ? "PASS" : "FAIL") << endl;
+    delete root;
+}
@@ -0,0 +1,82 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "pairing_heap.h"
+
+using namespace std;
+using namespace vvalgo;
+
+template <typename H, typename V>
+void printPops(H &heap, V head) {
+    cout << "************************************************\n";
+    while (!heap.isEmpty()) {
+        heap.peekHead(head);
+        heap.popHead();
+        cout << head << " ";
+    }
+    cout << "\n************************************************\n";
+}
+
+int main() {
+    vector<long> v = { 99, 89, 79, 69, 59, 49, 39, 29, 19, 9};
+    PairingHeap<long> heap;
+    vector<PairingHeap<long>::Handle> handles;
+    for (auto x : v) {
+        handles.push_back(heap.insert(x));
+    }
+    long head = 0;
+    heap.peekHead(head);
+    cout << "head of the heap --> " << head << endl;
+    
+    cout << "Decreasing 59 to 1 and 89 to 20 :\n";
+    heap.decreaseKey(handles[4], 1);
+    heap.decreaseKey(handles[1], 20);
+    cout << "Increasing 99 to 100 via decreaseKey --> " << (heap.decreaseKey(handles[0], 100) ? "accepted" : "rejected") << endl;
+    heap.peekHead(head);
+    cout << "head of the heap --> " << head << endl;
+    
+    PairingHeap<long> other;
+    other.insert(5);
+    other.insert(-7);
+    auto h44 = other.insert(44);
+    heap.meld(other);
+    cout << "Melded in 5, -7 and 44. The other heap is now " << (other.isEmpty() ? "empty" : "not empty")
+         << ", this one has " << heap.size() << " elements.\n";
+    heap.decreaseKey(h44, 2); // Handles survive the meld.
+    printPops(heap, head);
+    
+    // Max heap through the predicate, with a larger random workload checked against std::sort.
+    PairingHeap<long, greater<long> > maxHeap;
+    vector<long> w;
+    for (long i = 0; i < 10000; ++i) {
+        w.push_back((i * 7919) % 10007);
+        maxHeap.insert(w.back());
+    }
+    sort(w.begin(), w.end(), greater<long>());
+    bool inOrder = true;
+    for (auto x : w) {
+        maxHeap.peekHead(head);
+        maxHeap.popHead();
+        inOrder = inOrder && (head == x);
+    }
+    cout << "Max pairing heap pops 10000 elements in order --> " << (inOrder ? "PASS" : "FAIL") << endl;
+}
@@ -0,0 +1,167 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "persistent_red_black_tree.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+
+// Count every heap allocation, to see how many nodes an update makes.
+static atomic<size_t> allocations(0);
+
+void *operator new(size_t size) {
+    void *memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    allocations.fetch_add(1, memory_order_relaxed);
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    std::free(memory);
+}
+
+typedef PersistentRBTree<ll, ll> Tree;
+
+bool sameAs(const Tree &tree, const map<ll, ll> &reference) {
+    if (tree.size() != reference.size()) {
+        return false;
+    }
+    auto expected = reference.begin();
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++expected) {
+        if ( (it.key() != expected->first) || (it.value() != expected->second) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    Tree tree;
+    for (ll key : {50, 20, 80, 10, 30}) {
+        tree.insert(key, key * 10);
+    }
+    Tree before = tree.snapshot();
+    tree.remove(20);
+    tree.insert(60, 600);
+    cout << "Snapshot: -> ";
+    for (auto it = before.begin(); it != before.end(); ++it) {
+        cout << it.key() << " ";
+    }
+    cout << "\nCurrent:  -> ";
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        cout << it.key() << " ";
+    }
+    cout << endl;
+    bool basics = before.find(20) && (*before.find(20) == 200) && !before.find(60) && !tree.find(20) &&
+                  (*tree.find(60) == 600) && !tree.insert(60, 1) && !tree.remove(20) && (before.size() == 5) &&
+                  (tree.size() == 5) && tree.isValid() && before.isValid();
+    cout << "Updates leave snapshots alone --> " << (basics ? "PASS" : "FAIL") << endl;
+
+    // Random updates, with a snapshot taken every so often and checked against a copy of std::map at the end.
+    mt19937_64 generator(44);
+    map<ll, ll> reference;
+    vector<pair<Tree, map<ll, ll> > > snapshots;
+    Tree random;
+    bool same = true;
+    for (int i = 0; i < 100000; ++i) {
+        ll key = static_cast<ll>(generator() % 3000);
+        if (generator() % 3) {
+            same = same && (random.insert(key, i) == reference.insert(make_pair(key, ll(i))).second);
+        } else {
+            same = same && (random.remove(key) == (reference.erase(key) == 1));
+        }
+        if (!(i % 5000)) {
+            snapshots.push_back(make_pair(random.snapshot(), reference));
+        }
+    }
+    same = same && sameAs(random, reference) && random.isValid();
+    for (auto &snapshot : snapshots) {
+        same = same && sameAs(snapshot.first, snapshot.second) && snapshot.first.isValid();
+    }
+    cout << "Random updates match std::map, " << snapshots.size() << " snapshots intact --> "
+         << (same ? "PASS" : "FAIL") << endl;
+
+    // A snapshot costs nothing, and an update a handful of nodes, however big the tree.
+    const ll KEYS = 1000000;
+    Tree big;
+    for (ll key = 0; key < KEYS; ++key) {
+        big.insert(2 * key, key);
+    }
+    size_t start = allocations.load();
+    Tree frozen = big.snapshot();
+    size_t snapshotAllocations = allocations.load() - start;
+    const int UPDATES = 10000;
+    start = allocations.load();
+    for (int i = 0; i < UPDATES; ++i) {
+        ll key = 2 * static_cast<ll>(generator() % KEYS);
+        if (i & 1) {
+            big.remove(key);
+        } else {
+            big.insert(key + 1, i);
+        }
+    }
+    double perUpdate = double(allocations.load() - start) / UPDATES;
+    bool cheap = !snapshotAllocations && (perUpdate < 3 * 20) && frozen.isValid() && (frozen.size() == KEYS);
+    cout << "\n" << KEYS << " keys: " << snapshotAllocations << " allocations per snapshot, " << perUpdate
+         << " per update --> " << (cheap ? "PASS" : "FAIL") << endl;
+
+    // A long scan of a snapshot in another thread, while this one keeps updating.
+    Tree scanned = big.snapshot();
+    ll expectedSum = 0;
+    for (auto it = scanned.begin(); it != scanned.end(); ++it) {
+        expectedSum += it.key();
+    }
+    ll scannedSum = 0;
+    thread scanner([&scanned, &scannedSum]() {
+        for (int pass = 0; pass < 3; ++pass) {
+            ll sum = 0;
+            for (auto it = scanned.begin(); it != scanned.end(); ++it) {
+                sum += it.key();
+            }
+            scannedSum = sum;
+        }
+    });
+    for (int i = 0; i < 100000; ++i) {
+        ll key = static_cast<ll>(generator() % (2 * KEYS));
+        if (i & 1) {
+            big.remove(key);
+        } else {
+            big.insert(key, i);
+        }
+    }
+    scanner.join();
+    bool isolated = (scannedSum == expectedSum) && big.isValid() && scanned.isValid();
+    cout << "Scan of a snapshot during updates --> " << (isolated ? "PASS" : "FAIL") << endl;
+}
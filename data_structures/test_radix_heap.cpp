@@ -0,0 +1,148 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <set>
+#include <random>
+
+#include "heap.h"
+#include "radix_heap.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef unsigned long long ull;
+
+// Works with any heap exposing the isEmpty/peekHead/popHead surface.
+template <typename H, typename V>
+void printPops(H &heap, V head) {
+    cout << "************************************************\n";
+    while (!heap.isEmpty()) {
+        heap.peekHead(head);
+        heap.popHead();
+        cout << head << " ";
+    }
+    cout << "\n************************************************\n";
+}
+
+struct DistanceOf { // Key extractor for (distance, vertex) pairs.
+    ull operator()(const pair<ull, int> &entry) const {return entry.first;}
+};
+
+int main() {
+    vector<ull> v = { 99, 89, 79, 69, 59, 49, 39, 29, 19, 9, 49, 0};
+    
+    RadixHeap<ull> radix;
+    Heap<decltype(v.begin())> heap;
+    for (auto x : v) {
+        radix.insert(x);
+        heap.insert(x);
+    }
+    cout << "Popping everything from the radix heap:\n";
+    printPops(radix, ull());
+    cout << "Popping everything from the comparison based heap:\n";
+    printPops(heap, ull());
+    
+    // Monotone use: insert keys at or after the current head while popping.
+    radix.insert(100);
+    radix.insert(104);
+    ull head = 0;
+    radix.peekHead(head);
+    radix.popHead();
+    cout << "Popped " << head << ", inserting 102 --> " << (radix.insert(102) ? "accepted" : "rejected") << endl;
+    cout << "Inserting 50 (smaller than the last head) --> " << (radix.insert(50) ? "accepted" : "rejected") << endl;
+    printPops(radix, ull());
+
+    // Peeking is not popping: a key below the peeked head but not below the last popped one is still accepted,
+    // and becomes the new head.
+    radix.insert(200);
+    radix.insert(300);
+    radix.peekHead(head);
+    radix.popHead();
+    radix.insert(260);
+    radix.peekHead(head); // 260
+    bool afterPeek = radix.insert(250) && radix.insert(0x100 + 0x3F) && radix.peekHead(head) && (head == 250) &&
+                     !radix.insert(199);
+    radix.popHead();
+    afterPeek = afterPeek && radix.peekHead(head) && (head == 260) && !radix.insert(249);
+    cout << "Insert after peek keeps the popped key as the limit --> " << (afterPeek ? "PASS" : "FAIL") << endl;
+    printPops(radix, ull());
+
+    // Random peeks, pops and inserts at or above the last popped key, against std::multiset.
+    mt19937_64 generator(28);
+    multiset<ull> reference;
+    ull popped = 0;
+    bool same = true;
+    for (int i = 0; i < 200000; ++i) {
+        unsigned action = generator() % 4;
+        if (action < 2) {
+            ull key = popped + generator() % ((generator() & 1) ? 16 : 1000000);
+            same = same && radix.insert(key);
+            reference.insert(key);
+        } else if (action == 2) {
+            same = same && (radix.peekHead(head) == !reference.empty()) && (reference.empty() || (head == *reference.begin()));
+        } else if (!reference.empty()) {
+            radix.peekHead(head);
+            radix.popHead();
+            popped = *reference.begin();
+            same = same && (head == popped);
+            reference.erase(reference.begin());
+            if (reference.empty()) {
+                popped = 0;
+            }
+        }
+        same = same && (radix.size() == reference.size()) && (!popped || !radix.insert(popped - 1));
+    }
+    cout << "Random peeks, pops and monotone inserts match std::multiset --> " << (same ? "PASS" : "FAIL") << endl;
+    
+    // Dijkstra on a small graph with (distance, vertex) entries.
+    vector<vector<pair<int, ull> > > graph = {
+        {{1, 7}, {2, 9}, {5, 14}},
+        {{0, 7}, {2, 10}, {3, 15}},
+        {{0, 9}, {1, 10}, {3, 11}, {5, 2}},
+        {{1, 15}, {2, 11}, {4, 6}},
+        {{3, 6}, {5, 9}},
+        {{0, 14}, {2, 2}, {4, 9}}
+    };
+    const ull INF = ~0ULL;
+    vector<ull> distance(graph.size(), INF);
+    RadixHeap<pair<ull, int>, DistanceOf> frontier;
+    distance[0] = 0;
+    frontier.insert(make_pair(0ULL, 0));
+    pair<ull, int> entry;
+    while (frontier.peekHead(entry)) {
+        frontier.popHead();
+        if (entry.first != distance[entry.second]) {
+            continue; // Stale entry.
+        }
+        for (auto &edge : graph[entry.second]) {
+            ull candidate = entry.first + edge.second;
+            if (candidate < distance[edge.first]) {
+                distance[edge.first] = candidate;
+                frontier.insert(make_pair(candidate, edge.first));
+            }
+        }
+    }
+    cout << "Shortest distances from vertex 0 (expect 0 7 9 20 20 11) :\n";
+    for (auto d : distance) {
+        cout << d << " ";
+    }
+    cout << endl;
+}
@@ -0,0 +1,182 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+
+#include "tree_traversal.h"
+#include "red_black_tree.h"
+#include "red_black_set_operations.h"
+#include "order_statistic_tree.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+typedef RBTree<ll> Node;
+typedef chrono::duration<double, milli> Ms;
+
+template <typename NodePtr>
+vector<ll> values(NodePtr root) {
+    vector<ll> out;
+    inorderTraverse(root, [&out](NodePtr node) {out.push_back(node->value); return false;});
+    return out;
+}
+
+// A tree of the given values, inserted in random order so the shape is not a perfect one.
+template <typename NodePtr>
+NodePtr randomTree(const set<ll> &keys, mt19937_64 &generator) {
+    vector<ll> order(keys.begin(), keys.end());
+    shuffle(order.begin(), order.end(), generator);
+    NodePtr root = nullptr;
+    for (ll key : order) {
+        RB::insert(&root, key);
+    }
+    return root;
+}
+
+set<ll> randomSet(size_t count, ll range, mt19937_64 &generator) {
+    set<ll> keys;
+    while (keys.size() < count) {
+        keys.insert(static_cast<ll>(generator() % range));
+    }
+    return keys;
+}
+
+// The three operations on random sets of many sizes, against the std::set_ algorithms.
+bool matchesStd(ForkJoinPool *pool, mt19937_64 &generator) {
+    bool same = true;
+    for (int round = 0; round < 200; ++round) {
+        size_t sizes[] = {0, 1, 2, 10, 100, 1000, 5000};
+        set<ll> a = randomSet(sizes[generator() % 7], 20000, generator);
+        set<ll> b = randomSet(sizes[generator() % 7], 20000, generator);
+        vector<ll> expected[3];
+        set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected[0]));
+        set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected[1]));
+        set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(expected[2]));
+        for (int operation = 0; operation < 3; ++operation) {
+            Node *x = randomTree<Node *>(a, generator), *y = randomTree<Node *>(b, generator);
+            Node *result;
+            if (operation == 0) {
+                result = pool ? RB::unite(*pool, x, y) : RB::unite(x, y);
+            } else if (operation == 1) {
+                result = pool ? RB::intersect(*pool, x, y) : RB::intersect(x, y);
+            } else {
+                result = pool ? RB::subtract(*pool, x, y) : RB::subtract(x, y);
+            }
+            same = same && RB::isValid(result) && (values(result) == expected[operation]);
+            delete result;
+        }
+    }
+    return same;
+}
+
+int main(int argc, char **argv) {
+    mt19937_64 generator(46);
+
+    // join and split on their own.
+    set<ll> small = randomSet(500, 100000, generator);
+    set<ll> large = randomSet(20000, 100000, generator);
+    bool pieces = true;
+    for (int round = 0; round < 100; ++round) {
+        set<ll> keys = (round & 1) ? small : large;
+        Node *root = randomTree<Node *>(keys, generator);
+        ll pivot = static_cast<ll>(generator() % 100000);
+        Node *less, *greater;
+        Node *found = RB::split(root, pivot, &less, &greater);
+        vector<ll> below(keys.begin(), keys.lower_bound(pivot)), above(keys.upper_bound(pivot), keys.end());
+        pieces = pieces && RB::isValid(less) && RB::isValid(greater) && (values(less) == below) &&
+                 (values(greater) == above) && ((found != nullptr) == (keys.count(pivot) == 1));
+        if (!found) {
+            found = new Node(pivot);
+        }
+        root = RB::join(less, found, greater);
+        keys.insert(pivot);
+        pieces = pieces && RB::isValid(root) && (values(root) == vector<ll>(keys.begin(), keys.end()));
+        root = RB::split(root, pivot, &less, &greater);
+        delete root;
+        root = RB::join(less, greater);
+        keys.erase(pivot);
+        pieces = pieces && RB::isValid(root) && (values(root) == vector<ll>(keys.begin(), keys.end()));
+        delete root;
+    }
+    cout << "split and join keep order and balance --> " << (pieces ? "PASS" : "FAIL") << endl;
+
+    ForkJoinPool pool(4);
+    cout << "Sequential set operations match std --> " << (matchesStd(nullptr, generator) ? "PASS" : "FAIL") << endl;
+    cout << "Parallel set operations match std --> " << (matchesStd(&pool, generator) ? "PASS" : "FAIL") << endl;
+
+    // Augmented nodes stay consistent through all the joining.
+    OrderStatisticTree<ll> *ranked = randomTree<OrderStatisticTree<ll> *>(large, generator);
+    ranked = RB::unite(pool, ranked, randomTree<OrderStatisticTree<ll> *>(small, generator));
+    bool augmented = RB::isValid(ranked) && OS::isValid(ranked);
+    ranked = RB::subtract(ranked, randomTree<OrderStatisticTree<ll> *>(small, generator));
+    augmented = augmented && OS::isValid(ranked) && (OS::size(ranked) == values(ranked).size());
+    delete ranked;
+    cout << "Order statistics after unite and subtract --> " << (augmented ? "PASS" : "FAIL") << endl;
+
+    // Union of m keys into a tree of a million, against inserting them one at a time (which is what traversing
+    // one tree and reinserting into the other comes to). Pass the pool's thread count; the default is 4.
+    const int THREADS = (argc > 1) ? atoi(argv[1]) : 4;
+    ForkJoinPool workers(THREADS);
+    const ll N = 1000000;
+    vector<ll> base(N);
+    for (ll i = 0; i < N; ++i) {
+        base[i] = 2 * i;
+    }
+    cout << "\nm\treinsert ms\tunite ms\tunite on " << THREADS << " threads ms\n";
+    for (size_t m : {1000, 100000, 1000000}) {
+        vector<ll> extra;
+        for (size_t i = 0; i < m; ++i) {
+            extra.push_back(static_cast<ll>(generator() % (4 * N)));
+        }
+        sort(extra.begin(), extra.end());
+        extra.erase(unique(extra.begin(), extra.end()), extra.end());
+        Node *trees[3][2];
+        for (auto &t : trees) {
+            t[0] = t[1] = nullptr;
+            RB::build(&t[0], base.begin(), base.end());
+            RB::build(&t[1], extra.begin(), extra.end());
+        }
+        auto start = chrono::steady_clock::now();
+        for (Node *node = BST::min(trees[0][1]); node; node = BST::successor(node)) {
+            RB::insert(&trees[0][0], node->value);
+        }
+        Ms reinsertMs = chrono::steady_clock::now() - start;
+        delete trees[0][1];
+        start = chrono::steady_clock::now();
+        Node *sequential = RB::unite(trees[1][0], trees[1][1]);
+        Ms uniteMs = chrono::steady_clock::now() - start;
+        start = chrono::steady_clock::now();
+        Node *parallel = RB::unite(workers, trees[2][0], trees[2][1]);
+        Ms parallelMs = chrono::steady_clock::now() - start;
+        bool same = (values(sequential) == values(trees[0][0])) && (values(parallel) == values(trees[0][0])) &&
+                    RB::isValid(parallel);
+        cout << m << "\t" << reinsertMs.count() << "\t\t" << uniteMs.count() << "\t\t" << parallelMs.count()
+             << "\t\t\t" << (same ? "PASS" : "FAIL") << endl;
+        delete trees[0][0];
+        delete sequential;
+        delete parallel;
+    }
+}
@@ -17,206 +17,48 @@
  */
 
 #include <iostream>
-namespace vvalgo {
-    
-    /*
-     * General traversal function. It invokes pre(), in() and post() callbacks in the pre-order, inorder
-     * and post-order traversal fashion.
-     *
-     * Important Points to Note:
-     * - On Callbacks: If we perform a particular traversal, we guarantee that the relevant callback will be executed.
-     * - On Traversal: Once a callback returns true, to indicate that the traversal can stop, we prevent further traversal.
-     *
-     * As a result of these two points, an interesting situation arises. If we have gone down the left
-     * subtree and some callback returns true, do we invoke the in() callback of the node? If we had gone
-     * down the right subtree and then a callback returned true, do we invoke the post() callback?
-     * The answer is, yes we do. This comes from the first of the two assurances we mentioned above. If
-     * we have performed a particular traversal, we will invoke the relevant callback.
-     *
-     * This has a very interesting repurcussions on the way you would write callbacks. Since all the pre() callbacks
-     * are called once we descend down a tree, pre() will never be invoked once any of the callbacks stops the traversal.
-     * in() is performed after the left subtree has been traversed (may be partially traversed if a callback stopped the
-     * traversal). This means, in() should be invoked regardless of whether or not further traversal has been cancelled.
-     * Similar situation applies for post(). Once we have traversed down the right subtree, we are obliged to invoke
-     * post() regardless of any indications related to stopping traversal.
-     *
-     */
-    template <typename T, typename U, typename V, typename W>
-    void traverse(T *root, U pre, V in, W post) {
-        bool stopTraversal = false;
-        std::function<void (T *)> traversalHelper = [&](T *node) {
-            if (stopTraversal || !node) {
-                return;
-            }
-            
-            if (pre(node)) { // Perform pre-order processing
-                stopTraversal = true;
-                return;
-            }
-            
-            traversalHelper(node->left); // Traverse the left subtree.
-            if (in(node)) { // // Perform inorder processing.
-                stopTraversal = true;
-            }
-            if (stopTraversal) {// Keeping this out of the if (in(node)) block allows us to return if stopTraversal was
-                                // initially set to true inside the call traversalHelper(node->left)
-                return;
-            }
-            
-            traversalHelper(node->right); // Traverse the righ subtree.
-            if (post(node)) { // Perform post-order processing
-                stopTraversal = true;
-            }
-        };
-        
-        // Kick off the traversal
-        traversalHelper(root);
-    }
-    
-    /*
-     * Expected signature for foo(): bool (*)(T *); // return true if you have accomplished your goal and want traversal to stop prematurely.
-     *
-     * It is our responsibility to ensure that foo() is never called once it has returned true. This way,
-     * all the complexity related to ensuring this behavior lies within the traversal code rather than being spread
-     * out among all the implementations of foo(). This will result in less bugs in the system by reducing the
-     * number of code-paths to be tested.
-     */
-    template <typename T, typename V>
-    void inorderTraverse(T *root, V foo) {
-        auto noop = [](T *){return false;};
-        traverse(root, noop, foo, noop);
-    } // FN : inorderTraverse
-    
-    template <typename T, typename V>
-    void preorderTraverse(T *root, V foo) {
-        auto noop = [](T *){return false;};
-        traverse(root, foo, noop, noop);
-    } // FN : preorderTraverse
-    
-    template <typename T, typename V>
-    void postorderTraverse(T *root, V foo) {
-        auto noop = [](T *){return false;};
-        traverse(root, noop, noop, foo);
-    } // FN : postorderTraverse
-
-    namespace BST { // Encapsulating BST related functions inside a separate namespace.
-        // find() will perform binary search since we are dealing with a binary search tree
-        template <typename BSTType, typename ValueType>
-        BSTType *find(BSTType *root, ValueType val) {
-            if (!root || (val == root->value)) {
-                return root;
-            }
-            if (val < root->value) {
-                return find(root->left, val);
-            }
-            return find(root->right, val);
-        }
-
-        // insert() will perform a binary search to find the entry or insert the node at the right location
-        template <typename BSTType, typename ValueType>
-        BSTType *insert(BSTType **root, ValueType val, BSTType *parentOfRoot = nullptr) {
-            if (!root) {
-                return nullptr;
-            }
-            if (!(*root)) {
-                *root = new BSTType(val, nullptr, nullptr, parentOfRoot);
-                return *root;
-            }
-            if (val < (*root)->value) {
-                return insert(&(*root)->left, val, *root);
-            }
-            return insert(&(*root)->right, val, *root);
-        }
-
-        // returns the minimum node in the BST
-        template <typename BSTType>
-        BSTType *min(BSTType *root) {
-            if (!root || !root->left) {
-                return root;
-            }
-            return min(root->left);
-        }
-
-        // Removes a node with the given value, if it exists.
-        template <typename BSTType, typename ValueType>
-        void remove(BSTType **root, ValueType val) {
-            if (!root || !*root) {
-                return;
-            }
-            BSTType *node = *root;
-            if (node->value == val) { // Found the target node.
-                if (!node->left && !node->right) {      // Target is a leaf node.
-                    *root = nullptr;
-                    delete node;
-                } else if (node->left && node->right) { // Target has two children.
-                    BSTType *successor = min(node->right);
-                    node->value = successor->value;
-                    remove(&(node->right), successor->value);
-                } else {                                // Target node has only one child.
-                    BSTType *loneChild = (node->left) ? node->left : node->right;
-                    *root = loneChild;
-                    loneChild->parent = node->parent; // Update the parent pointer of the lone child.
-                    node->left = node->right = node->parent = nullptr;// nil out child pointers because delete cascades to these via the destructor.
-                    delete node;
-                }
-            } else if (val < node->value) { // Search in the left subtree
-                remove(&(node->left), val);
-            } else {                        // Search in the left subtree
-                remove(&(node->right), val);
-            }
-        }
-        
-        // Test ancestory
-        template <typename TType>
-        size_t depth(TType *node) {
-            if (!node) {
-                return 0;   // This has an overloaded meaning now. 0 means the node does not exist in the tree.
-                            // It also prevents us from assigning this depth to the root noew. I could
-                            // circumvent this by returning -1 for !node, while returning 0 for !node->parent.
-                            // But using a signed type for the return value, and overloading the meaning of the
-                            // return value doesnt seem like the right solution. Will mull this over later.
-            }
-            return 1 + depth(node->parent); // To make this tail recursive, I can add an accumulator into the parameter list.
-        }
-        
-    } // NS : BST
-    
-    
-    template <typename ValueType>
-    class RBTree {
-    public:
-        ValueType value;
-        RBTree *left;   // TODO: convert to unique_ptr
-        RBTree *right;  // TODO: convert to unique_ptr
-        RBTree *parent; // TODO: should NOT convert to unique_ptr. We need weak_ptr here.
-        
-        // It is important to always allocate RBTree objects on the heap because we are calling delete
-        // in the destructor for the children. Except for the root, every node in the RBTree needs to be
-        // allocated on the heap for this to work correctly. The ideal way would be to not use this exception and
-        // just allocate the root on the heap as well.
-        RBTree(ValueType val, RBTree *l=nullptr, RBTree *r = nullptr, RBTree *p = nullptr) : value(val), parent(p), left(l), right(r) {}
-        
-        ~RBTree() {
-            delete left; // It is safe to pass nullptr to delete, so no need to check for it.
-            delete right;
-        }
-        
-        RBTree &insert(ValueType value){
-            // Perform binary search.
-            // If the node we found already contains this value, we are done.
-            // Otherwise add this node as the child of the node we found.
-        }
-    }; // CS : RBTree
 
-} // NS : vvalgo
+#include "tree_traversal.h"
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+#include "compact_tree.h"
+#include "order_statistic_tree.h"
 
 #include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
 
 using namespace std;
 using namespace vvalgo;
 
 typedef long long ll;
 
+typedef chrono::duration<double, milli> Ms;
+
+// Inserts keys into an empty tree with insert(), then finds each of them. Prints the times and the height.
+template <typename Insert>
+void benchmark(const char *name, const vector<ll> &keys, Insert insert) {
+    RBTree<ll> *root = nullptr;
+    auto start = chrono::steady_clock::now();
+    for (ll key : keys) {
+        insert(&root, key);
+    }
+    Ms insertMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    size_t found = 0;
+    for (ll key : keys) {
+        found += (BST::find(root, key) != nullptr);
+    }
+    Ms findMs = chrono::steady_clock::now() - start;
+    cout << name << "\t" << keys.size() << "\t" << insertMs.count() << "\t\t" << findMs.count() << "\t\t"
+         << RB::height(root) << "\t" << ((found == keys.size()) ? "PASS" : "FAIL") << endl;
+    delete root;
+}
+
 int main() {
     RBTree<ll> *root = nullptr;
     BST::insert(&root, 1000);
@@ -274,4 +116,221 @@ int main() {
     cout << "------------  750 is this deep: " << BST::depth(BST::find(root, 750)) << endl;
     cout << "------------ 1500 is this deep: " << BST::depth(BST::find(root, 1500)) << endl;
     cout << "------------ 2000 is this deep: " << BST::depth(BST::find(root, 2000)) << endl;
+
+    // The same operations on nodes from a pool.
+    NodePool<RBTree<ll> > pool;
+    RBTree<ll> *pooled = nullptr;
+    for (ll value : {1000, 500, 1500, 250, 750, 2000, 3000}) {
+        BST::insert(&pooled, value, pool);
+    }
+    BST::remove(&pooled, 3000, pool);
+    BST::remove(&pooled, 1500, pool);
+    BST::remove(&pooled, 500, pool);
+    BST::remove(&pooled, 1000, pool);
+    BST::insert(&pooled, 1500, pool);
+    cout << "Pooled inorder: -> ";
+    inorderTraverse(pooled, printer);
+    cout << "(" << pool.size() << " nodes, 1500 is " << BST::depth(BST::find(pooled, 1500)) << " deep)" << endl;
+    pool.destroyTree(pooled);
+
+    cout << "Morris inorder: -> ";
+    morrisInorderTraverse(root, printer);
+    cout << endl;
+
+    cout << "Level-order: -> ";
+    for (auto &node : levelorder(root)) {
+        cout << node.value << " ";
+    }
+    cout << endl;
+    delete root;
+
+    // A real red-black tree. Random inserts and removes against std::set, checking every invariant as we go.
+    mt19937_64 generator(5);
+    RBTree<ll> *tree = nullptr;
+    set<ll> reference;
+    bool valid = true;
+    for (int i = 0; i < 100000; ++i) {
+        ll value = static_cast<ll>(generator() % 2000);
+        if (generator() % 2) {
+            RBTree<ll> *node = RB::insert(&tree, value);
+            valid = valid && node && (node->value == value);
+            reference.insert(value);
+        } else {
+            valid = valid && (RB::remove(&tree, value) == (reference.erase(value) == 1));
+        }
+        if (!(i % 1000)) {
+            valid = valid && RB::isValid(tree);
+        }
+    }
+    vector<ll> values;
+    inorderTraverse(tree, [&values](RBTree<ll> *node) {values.push_back(node->value); return false;});
+    valid = valid && RB::isValid(tree) && (values == vector<ll>(reference.begin(), reference.end()));
+    cout << "\nRandom inserts and removes keep the red-black invariants --> " << (valid ? "PASS" : "FAIL") << endl;
+    while (tree) {
+        RB::remove(&tree, tree->value);
+    }
+
+    // Sorted input: the height stays within 2 log2(n + 1).
+    const ll SORTED = 1000000;
+    for (ll i = 0; i < SORTED; ++i) {
+        RB::insert(&tree, i);
+    }
+    size_t height = RB::height(tree);
+    cout << "Height after " << SORTED << " sorted inserts: " << height << " <= " << 2 * log2(SORTED + 1.0) << " --> "
+         << ( (RB::isValid(tree) && (height <= 2 * log2(SORTED + 1.0))) ? "PASS" : "FAIL" ) << endl;
+    for (ll i = 0; i < SORTED; i += 2) {
+        RB::remove(&tree, i);
+    }
+    height = RB::height(tree);
+    cout << "Height after removing every other one: " << height << " --> "
+         << ( (RB::isValid(tree) && (height <= 2 * log2(SORTED / 2 + 1.0))) ? "PASS" : "FAIL" ) << endl;
+    delete tree;
+
+    // The same code balances pooled nodes and compact nodes.
+    NodePool<RBTree<ll> > rbPool;
+    RBTree<ll> *pooledTree = nullptr;
+    CompactRBNode<int>::Ptr compactTree;
+    for (int i = 0; i < 100000; ++i) {
+        int value = static_cast<int>(generator() % 50000);
+        if (generator() % 3) {
+            RB::insert(&pooledTree, value, rbPool);
+            RB::insert(&compactTree, value);
+        } else {
+            RB::remove(&pooledTree, value, rbPool);
+            RB::remove(&compactTree, value);
+        }
+    }
+    valid = RB::isValid(pooledTree) && RB::isValid(compactTree);
+    valid = valid && (rbPool.size() == CompactArena<CompactRBNode<int> >::instance().size());
+    cout << "Pooled and compact red-black trees --> " << (valid ? "PASS" : "FAIL") << endl;
+    rbPool.destroyTree(pooledTree);
+    destroyTree(compactTree);
+
+    // Sorted against random insertion, for the unbalanced BST and the red-black tree. The BST is quadratic on
+    // sorted input, so it only gets a small one.
+    cout << "\ntree\t\tkeys\tinsert ms\tfind ms\t\theight\tfound all\n";
+    vector<ll> sorted(20000), shuffled;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        sorted[i] = static_cast<ll>(i);
+    }
+    auto bstInsert = [](RBTree<ll> **root, ll key) {BST::insert(root, key);};
+    auto rbInsert = [](RBTree<ll> **root, ll key) {RB::insert(root, key);};
+    benchmark("BST, sorted", sorted, bstInsert);
+    benchmark("RB, sorted", sorted, rbInsert);
+    sorted.resize(1000000);
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        sorted[i] = static_cast<ll>(i);
+    }
+    shuffled = sorted;
+    shuffle(shuffled.begin(), shuffled.end(), generator);
+    benchmark("RB, sorted", sorted, rbInsert);
+    benchmark("BST, random", shuffled, bstInsert);
+    benchmark("RB, random", shuffled, rbInsert);
+
+    // Bulk building: every size up to a few hundred comes out valid, in order, and as low as a tree can be.
+    bool built = true;
+    for (ll n = 0; n < 300; ++n) {
+        vector<ll> input;
+        for (ll i = 0; i < n; ++i) {
+            input.push_back(3 * i);
+            input.push_back(3 * i); // Repeats are skipped.
+        }
+        RBTree<ll> *bulk = nullptr;
+        built = built && RB::build(&bulk, input.begin(), input.end()) && RB::isValid(bulk);
+        vector<ll> out;
+        inorderTraverse(bulk, [&out](RBTree<ll> *node) {out.push_back(node->value); return false;});
+        input.erase(unique(input.begin(), input.end()), input.end());
+        built = built && (out == input) && (RB::height(bulk) == static_cast<size_t>(n ? log2(n) + 1 : 0));
+        delete bulk;
+    }
+    vector<ll> unsorted = {1, 3, 2};
+    RBTree<ll> *bulk = nullptr;
+    built = built && !RB::build(&bulk, unsorted.begin(), unsorted.end()) && !bulk;
+    built = built && RB::build(&bulk, sorted.begin(), sorted.begin() + 10) &&
+            !RB::build(&bulk, sorted.begin(), sorted.end()); // Only into an empty tree.
+    delete bulk;
+    OrderStatisticTree<ll> *ranked = nullptr;
+    built = built && RB::build(&ranked, sorted.begin(), sorted.begin() + 1000) && OS::isValid(ranked) &&
+            (OS::select(ranked, 123)->value == 123) && (OS::rank(ranked, 777) == 777);
+    delete ranked;
+    cout << "\nBulk builds are valid, minimal and augmented --> " << (built ? "PASS" : "FAIL") << endl;
+
+    // Batches in any order, small and large, against std::set. Nodes already in the tree stay where they are.
+    RBTree<ll> *batched = nullptr;
+    reference.clear();
+    RB::insert(&batched, -1);
+    RBTree<ll> *first = batched;
+    bool merged = true;
+    for (size_t batchSize : {1, 5, 200, 3000, 10, 50000, 2}) {
+        vector<ll> batch;
+        for (size_t i = 0; i < batchSize; ++i) {
+            batch.push_back(static_cast<ll>(generator() % 200000));
+        }
+        RB::insertBatch(&batched, batch);
+        reference.insert(batch.begin(), batch.end());
+        vector<ll> out;
+        inorderTraverse(batched, [&out](RBTree<ll> *node) {out.push_back(node->value); return false;});
+        reference.insert(-1);
+        merged = merged && RB::isValid(batched) && (out == vector<ll>(reference.begin(), reference.end())) &&
+                 (BST::find(batched, -1) == first);
+    }
+    delete batched;
+    cout << "Batched inserts match std::set --> " << (merged ? "PASS" : "FAIL") << endl;
+
+    // A million sorted keys, one at a time against one build, then a scan of each. The pool lays the built
+    // nodes out in key order.
+    cout << "\nkeys\tinsert ms\tbuild ms\tpooled build ms\tscan inserted ms\tscan built ms\n";
+    RBTree<ll> *inserted = nullptr, *plain = nullptr, *packed = nullptr;
+    NodePool<RBTree<ll> > buildPool;
+    auto start = chrono::steady_clock::now();
+    for (ll key : sorted) {
+        RB::insert(&inserted, key);
+    }
+    Ms insertMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    RB::build(&plain, sorted.begin(), sorted.end());
+    Ms buildMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    RB::build(&packed, sorted.begin(), sorted.end(), buildPool);
+    Ms poolMs = chrono::steady_clock::now() - start;
+    auto scan = [](RBTree<ll> *root, ll &checksum) {
+        auto begin = chrono::steady_clock::now();
+        for (RBTree<ll> *node = BST::min(root); node; node = BST::successor(node)) {
+            checksum ^= node->value;
+        }
+        return Ms(chrono::steady_clock::now() - begin);
+    };
+    ll checksums[2] = {0, 0};
+    Ms scanInserted = scan(inserted, checksums[0]);
+    Ms scanBuilt = scan(packed, checksums[1]);
+    cout << sorted.size() << "\t" << insertMs.count() << "\t\t" << buildMs.count() << "\t\t" << poolMs.count()
+         << "\t\t" << scanInserted.count() << "\t\t\t" << scanBuilt.count() << "\t"
+         << ( (checksums[0] == checksums[1]) && RB::isValid(packed) ? "PASS" : "FAIL" ) << endl;
+    delete plain;
+    buildPool.destroyTree(packed);
+
+    // Random batches into that million-key tree: one insert at a time against insertBatch().
+    cout << "\nbatch\tinserts ms\tinsertBatch ms\n";
+    for (size_t batchSize : {1000, 100000, 1000000}) {
+        vector<ll> batch;
+        for (size_t i = 0; i < batchSize; ++i) {
+            batch.push_back(static_cast<ll>(generator() % (4 * sorted.size())));
+        }
+        RBTree<ll> *one = nullptr, *all = nullptr;
+        RB::build(&one, sorted.begin(), sorted.end());
+        RB::build(&all, sorted.begin(), sorted.end());
+        start = chrono::steady_clock::now();
+        for (ll key : batch) {
+            RB::insert(&one, key);
+        }
+        Ms oneMs = chrono::steady_clock::now() - start;
+        start = chrono::steady_clock::now();
+        RB::insertBatch(&all, batch);
+        Ms allMs = chrono::steady_clock::now() - start;
+        cout << batchSize << "\t" << oneMs.count() << "\t\t" << allMs.count() << "\t\t"
+             << ( RB::isValid(all) ? "PASS" : "FAIL" ) << endl;
+        delete one;
+        delete all;
+    }
+    delete inserted;
 }
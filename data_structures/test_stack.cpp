@@ -17,8 +17,37 @@
  */
 
 #include <iostream>
+#include <vector>
+#include <stack>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
 #include "stack.h"
 
+struct Frame { // Typical short lived parser frame.
+	int state;
+	int token;
+	long long position;
+	Frame(int s = 0, int t = 0, long long p = 0) : state(s), token(t), position(p) {}
+};
+
+// Pushes and pops bursts of frames no deeper than 'depth' on a long lived container. Returns the elapsed milliseconds.
+template <typename Push, typename Pop>
+double timeBursts(long long bursts, int depth, Push push, Pop pop) {
+	auto start = std::chrono::steady_clock::now();
+	for (long long b = 0; b < bursts; ++b) {
+		for (int d = 0; d < depth; ++d) {
+			push(d, static_cast<int>(b), b + d);
+		}
+		for (int d = 0; d < depth; ++d) {
+			pop();
+		}
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
 int main() {
 
 	vvalgo::Stack<int> st;
@@ -41,5 +70,143 @@ int main() {
 		std::cout << i << std::endl;
 	}
 
+	// Moves, emplace and pop-into with an item type that is expensive to copy.
+	vvalgo::Stack<std::string, 2> words;
+	std::string hello = "hello";
+	words.push(hello);
+	words.push(std::string("move"));
+	words.emplace(3, 'x'); // Constructed in place, and the first item on the overflow.
+	words.top() += "!";
+	std::cout << "size --> " << words.size() << ", top --> " << words.top() << std::endl;
+	std::string out;
+	while (words.pop(out)) {
+		std::cout << out << " ";
+	}
+	std::cout << std::endl;
+
+	// Copies have to survive the original, both for the inline items and the overflow.
+	vvalgo::Stack<std::string, 2> copy;
+	{
+		vvalgo::Stack<std::string, 2> original;
+		for (int n = 0; n < 5; ++n) {
+			original.push(std::to_string(n));
+		}
+		copy = original;
+	}
+	while (copy.pop(out)) {
+		std::cout << out << " ";
+	}
+	std::cout << std::endl;
+
+	// Benchmark: bursts of shallow pushes and pops.
+	const long long bursts = 2000000;
+	const int depth = 12;
+	vvalgo::Stack<Frame> small;
+	std::vector<Frame> vec;
+	std::stack<Frame> stdStack;
+	Frame sink;
+	long long checksum = 0; // Consuming every popped frame keeps the optimizer from dropping the work.
+	double smallMs = timeBursts(bursts, depth, [&](int s, int t, long long p) {small.emplace(s, t, p);}, [&]() {small.pop(sink); checksum += sink.position;});
+	double vecMs = timeBursts(bursts, depth, [&](int s, int t, long long p) {vec.emplace_back(s, t, p);}, [&]() {sink = vec.back(); vec.pop_back(); checksum += sink.position;});
+	double stdMs = timeBursts(bursts, depth, [&](int s, int t, long long p) {stdStack.emplace(s, t, p);}, [&]() {sink = stdStack.top(); stdStack.pop(); checksum += sink.position;});
+	std::cout << "\n" << bursts << " bursts of " << depth << " push/pop pairs:\n";
+	std::cout << "vvalgo::Stack<Frame>  " << smallMs << " ms\n";
+	std::cout << "std::vector<Frame>    " << vecMs << " ms\n";
+	std::cout << "std::stack<Frame>     " << stdMs << " ms\n";
+	std::cout << "(checksum " << checksum << ")" << std::endl;
+
+	// Same workload, but every burst gets a fresh container the way a recursive descent parser creates one per call.
+	double freshTimes[3] = {0, 0, 0};
+	for (int kind = 0; kind < 3; ++kind) {
+		auto start = std::chrono::steady_clock::now();
+		for (long long b = 0; b < bursts; ++b) {
+			if (kind == 0) {
+				vvalgo::Stack<Frame> st2;
+				for (int d = 0; d < depth; ++d) {
+					st2.emplace(d, static_cast<int>(b), b + d);
+				}
+				while (st2.pop(sink)) {
+					checksum += sink.position;
+				}
+			} else if (kind == 1) {
+				std::vector<Frame> v2;
+				for (int d = 0; d < depth; ++d) {
+					v2.emplace_back(d, static_cast<int>(b), b + d);
+				}
+				while (!v2.empty()) {
+					checksum += v2.back().position;
+					v2.pop_back();
+				}
+			} else {
+				std::stack<Frame> s2;
+				for (int d = 0; d < depth; ++d) {
+					s2.emplace(d, static_cast<int>(b), b + d);
+				}
+				while (!s2.empty()) {
+					checksum += s2.top().position;
+					s2.pop();
+				}
+			}
+		}
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		freshTimes[kind] = elapsed.count();
+	}
+	std::cout << "\nWith a fresh container per burst:\n";
+	std::cout << "vvalgo::Stack<Frame>  " << freshTimes[0] << " ms (no heap allocation)\n";
+	std::cout << "std::vector<Frame>    " << freshTimes[1] << " ms\n";
+	std::cout << "std::stack<Frame>     " << freshTimes[2] << " ms\n";
+	std::cout << "(checksum " << checksum << ")" << std::endl;
+
+	// Segmented overflow: copies and pops across chunk boundaries.
+	typedef vvalgo::Stack<int, 4, vvalgo::SegmentedOverflow<int, 8> > SegmentedStack;
+	SegmentedStack segmented;
+	for (int n = 0; n < 100; ++n) {
+		segmented.push(n);
+	}
+	SegmentedStack segmentedCopy = segmented;
+	bool inOrder = (segmentedCopy.size() == 100);
+	for (int n = 99; n >= 0; --n) {
+		int item = -1;
+		inOrder = inOrder && segmentedCopy.pop(item) && (item == n);
+	}
+	std::cout << "\nSegmented stack copy pops 99..0 in order --> " << ((inOrder && segmentedCopy.is_empty()) ? "PASS" : "FAIL") << std::endl;
+
+	// No inline buffer at all: everything lives on the overflow, and moves of a container of stacks keep the items.
+	vvalgo::Stack<int, 0> heapOnly;
+	bool noInline = heapOnly.is_empty() && !heapOnly.pop();
+	heapOnly.push(1);
+	heapOnly.push(2);
+	int peeked = 0, popped = 0;
+	noInline = noInline && !heapOnly.is_empty() && heapOnly.peek(peeked) && (peeked == 2) && heapOnly.pop(popped) &&
+	           (popped == 2) && heapOnly.pop() && heapOnly.is_empty() && !heapOnly.peek(peeked);
+	static_assert(std::is_nothrow_move_constructible<vvalgo::Stack<int> >::value, "Stacks of ints move without throwing");
+	static_assert(std::is_nothrow_move_constructible<SegmentedStack>::value, "So do segmented ones");
+	std::vector<vvalgo::Stack<int, 0> > stacks(1);
+	stacks[0].push(7);
+	stacks.resize(100); // Moves stacks[0] rather than copying it.
+	noInline = noInline && stacks[0].peek(peeked) && (peeked == 7);
+	std::cout << "Stack<int, 0> keeps everything on the overflow --> " << (noInline ? "PASS" : "FAIL") << std::endl;
+
+	// Worst case single push latency while growing a deep stack, as in a DFS over a huge graph.
+	const long long frames = 20000000;
+	auto worstPush = [&](auto &deep) {
+		double worst = 0;
+		for (long long f = 0; f < frames; ++f) {
+			auto start = std::chrono::steady_clock::now();
+			deep.emplace(static_cast<int>(f), 0, f);
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			worst = std::max(worst, elapsed.count());
+		}
+		return worst;
+	};
+	{
+		vvalgo::Stack<Frame> deep;
+		std::cout << "Worst push latency growing to " << frames << " frames, vector overflow    --> " << worstPush(deep) << " ms" << std::endl;
+	}
+	{
+		vvalgo::Stack<Frame, 16, vvalgo::SegmentedOverflow<Frame, 4096> > deep;
+		std::cout << "Worst push latency growing to " << frames << " frames, segmented overflow --> " << worstPush(deep) << " ms" << std::endl;
+	}
+
 	return 0;
 }
@@ -0,0 +1,225 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "binary_tree.h"
+#include "binary_search_tree.h"
+#include "red_black_tree.h"
+#include "flat_search_tree.h"
+#include "tree_image.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+typedef TreeImage<ll>::Record Record;
+
+typedef chrono::duration<double, milli> Ms;
+
+const char *LINKED_FILE = "test_tree_image.linked";
+const char *FLAT_FILE = "test_tree_image.flat";
+const char *DAMAGED_FILE = "test_tree_image.damaged";
+
+vector<ll> preorderOf(const TreeImage<ll> &image) {
+    vector<ll> values;
+    vector<const Record *> pending;
+    if (image.root()) {
+        pending.push_back(image.root());
+    }
+    while (!pending.empty()) {
+        const Record *record = pending.back();
+        pending.pop_back();
+        values.push_back(record->value);
+        if (image.right(record)) {
+            pending.push_back(image.right(record));
+        }
+        if (image.left(record)) {
+            pending.push_back(image.left(record));
+        }
+    }
+    return values;
+}
+
+// A copy of from with its bytes changed by damage(), which gets them and may also shorten them.
+template <typename Damage>
+void copyDamaged(const char *from, Damage damage) {
+    vector<unsigned char> bytes;
+    FILE *in = fopen(from, "rb");
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        bytes.push_back(static_cast<unsigned char>(c));
+    }
+    fclose(in);
+    damage(bytes);
+    FILE *out = fopen(DAMAGED_FILE, "wb");
+    fwrite(bytes.data(), 1, bytes.size(), out);
+    fclose(out);
+}
+
+int main(int argc, char **argv) {
+    // A red-black tree, its flattened form, and an unordered BinaryTree, each written and read back.
+    mt19937_64 generator(50);
+    RBTree<ll> *tree = nullptr;
+    for (int i = 0; i < 5000; ++i) {
+        RB::insert(&tree, static_cast<ll>(generator() % 20000));
+    }
+    FlatSearchTree<ll> flat(tree);
+    TreeImage<ll> linkedImage, flatImage;
+    bool same = writeTreeImage(LINKED_FILE, tree) && writeTreeImage(FLAT_FILE, flat) && linkedImage.open(LINKED_FILE) &&
+                flatImage.open(FLAT_FILE) && !linkedImage.isFlat() && flatImage.isFlat() &&
+                (linkedImage.size() == flat.size()) && (flatImage.size() == flat.size());
+    for (ll probe = -1; same && (probe <= 20000); ++probe) {
+        RBTree<ll> *node = BST::find(tree, probe);
+        const ll *inLinked = linkedImage.find(probe);
+        const ll *inFlat = flatImage.find(probe);
+        const ll *bound = flat.lowerBound(probe);
+        same = ((inLinked != nullptr) == (node != nullptr)) && ((inFlat != nullptr) == (node != nullptr)) &&
+               (!node || ((*inLinked == probe) && (*inFlat == probe))) &&
+               ((linkedImage.lowerBound(probe) == nullptr) == (bound == nullptr)) &&
+               (!bound || ((*linkedImage.lowerBound(probe) == *bound) && (*flatImage.lowerBound(probe) == *bound)));
+    }
+    vector<ll> expected;
+    preorderTraverse(tree, [&expected](RBTree<ll> *node) {expected.push_back(node->value); return false;});
+    same = same && (preorderOf(linkedImage) == expected);
+    cout << "Red-black and flat images answer like the tree --> " << (same ? "PASS" : "FAIL") << endl;
+
+    BinaryTree<ll> *unordered = new BinaryTree<ll>{7, new BinaryTree<ll>{3, nullptr, new BinaryTree<ll>{9}},
+                                                   new BinaryTree<ll>{1, new BinaryTree<ll>{4}, new BinaryTree<ll>{8}}};
+    expected.clear();
+    preorderTraverse(unordered, [&expected](BinaryTree<ll> *node) {expected.push_back(node->value); return false;});
+    bool shape = writeTreeImage(LINKED_FILE, unordered, false) && linkedImage.open(LINKED_FILE) &&
+                 (preorderOf(linkedImage) == expected) && !linkedImage.left(linkedImage.right(linkedImage.left(linkedImage.root())));
+    delete unordered;
+    RBTree<ll> *empty = nullptr;
+    shape = shape && writeTreeImage(LINKED_FILE, empty) && linkedImage.open(LINKED_FILE) && !linkedImage.root() &&
+            !linkedImage.size() && !linkedImage.find(1);
+    cout << "BinaryTree shape and empty trees survive --> " << (shape ? "PASS" : "FAIL") << endl;
+
+    // Damaged, truncated, foreign and missing files are refused; without verify only the header is checked.
+    writeTreeImage(LINKED_FILE, tree);
+    TreeImage<ll> image;
+    copyDamaged(LINKED_FILE, [](vector<unsigned char> &bytes) {bytes[bytes.size() / 2] ^= 1;});
+    bool refused = !image.open(DAMAGED_FILE) && image.open(DAMAGED_FILE, false) && (image.size() == flat.size());
+    copyDamaged(LINKED_FILE, [](vector<unsigned char> &bytes) {
+        bytes[64 + 7] ^= 0x80; // Bit 63 of two payload words, which a plain multiply never carries down.
+        bytes[64 + 5 * 8 + 7] ^= 0x80;
+    });
+    refused = refused && !image.open(DAMAGED_FILE);
+    copyDamaged(LINKED_FILE, [](vector<unsigned char> &bytes) {bytes.resize(bytes.size() - 8);});
+    refused = refused && !image.open(DAMAGED_FILE, false) && !image.isOpen();
+    copyDamaged(LINKED_FILE, [](vector<unsigned char> &bytes) {bytes[12] += 1;}); // The version.
+    refused = refused && !image.open(DAMAGED_FILE, false);
+    writeTreeImage(LINKED_FILE, tree, false); // No checksum, so verify has to catch this from the links.
+    copyDamaged(LINKED_FILE, [](vector<unsigned char> &bytes) {
+        bytes[64 + 8] = 0; // The root's left child, now itself.
+        bytes[64 + 9] = bytes[64 + 10] = bytes[64 + 11] = 0;
+    });
+    refused = refused && !image.open(DAMAGED_FILE) && image.open(DAMAGED_FILE, false);
+    TreeImage<int> wrongType;
+    refused = refused && !wrongType.open(LINKED_FILE) && !image.open("no such file") && image.open(LINKED_FILE);
+    cout << "Damaged and foreign images are refused --> " << (refused ? "PASS" : "FAIL") << endl;
+
+    // Any two flipped bits of a small payload change the checksum.
+    unsigned char payload[64] = {0};
+    auto checksumOf = [&payload]() {
+        image_detail::Checksum sum;
+        sum.add(payload, sizeof(payload));
+        return sum.value();
+    };
+    const uint64_t clean = checksumOf();
+    bool distinct = true;
+    for (size_t first = 0; first < 8 * sizeof(payload); ++first) {
+        for (size_t second = first + 1; second < 8 * sizeof(payload); ++second) {
+            payload[first / 8] ^= static_cast<unsigned char>(1 << (first % 8));
+            payload[second / 8] ^= static_cast<unsigned char>(1 << (second % 8));
+            distinct = distinct && (checksumOf() != clean);
+            payload[first / 8] ^= static_cast<unsigned char>(1 << (first % 8));
+            payload[second / 8] ^= static_cast<unsigned char>(1 << (second % 8));
+        }
+    }
+    cout << "Every two-bit flip changes the checksum --> " << (distinct ? "PASS" : "FAIL") << endl;
+    delete tree;
+
+    // Startup: building the tree from its source data against mapping its image, then lookups in each. Pass
+    // the number of keys; the default is 4M.
+    const size_t N = (argc > 1) ? static_cast<size_t>(atoll(argv[1])) : 4000000;
+    vector<ll> keys(N);
+    for (ll &key : keys) {
+        key = static_cast<ll>(generator() >> 1);
+    }
+    auto start = chrono::steady_clock::now();
+    tree = nullptr;
+    for (ll key : keys) {
+        RB::insert(&tree, key);
+    }
+    Ms buildMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    FlatSearchTree<ll> big(tree);
+    bool written = writeTreeImage(LINKED_FILE, tree) && writeTreeImage(FLAT_FILE, big);
+    Ms writeMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    bool opened = linkedImage.open(LINKED_FILE, false) && flatImage.open(FLAT_FILE, false) &&
+                  linkedImage.find(keys[0]) && flatImage.find(keys[0]);
+    Ms openMs = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    opened = opened && linkedImage.open(LINKED_FILE) && flatImage.open(FLAT_FILE);
+    Ms verifyMs = chrono::steady_clock::now() - start;
+    cout << "\n" << N << " keys: build " << buildMs.count() << " ms, write both images " << writeMs.count()
+         << " ms, open both and look up " << openMs.count() << " ms, open and verify " << verifyMs.count()
+         << " ms --> " << (written && opened ? "PASS" : "FAIL") << endl;
+
+    const size_t LOOKUPS = 2000000;
+    vector<ll> probes(LOOKUPS);
+    for (ll &probe : probes) {
+        probe = (generator() & 1) ? keys[generator() % N] : static_cast<ll>(generator() >> 1);
+    }
+    size_t hits[3] = {0, 0, 0};
+    Ms lookupMs[3];
+    start = chrono::steady_clock::now();
+    for (ll probe : probes) {
+        hits[0] += (BST::find(tree, probe) != nullptr);
+    }
+    lookupMs[0] = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    for (ll probe : probes) {
+        hits[1] += (linkedImage.find(probe) != nullptr);
+    }
+    lookupMs[1] = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    for (ll probe : probes) {
+        hits[2] += (flatImage.find(probe) != nullptr);
+    }
+    lookupMs[2] = chrono::steady_clock::now() - start;
+    cout << "ns per lookup:\ntree\tlinked image\tflat image\n" << lookupMs[0].count() * 1e6 / LOOKUPS << "\t"
+         << lookupMs[1].count() * 1e6 / LOOKUPS << "\t\t" << lookupMs[2].count() * 1e6 / LOOKUPS << "\t\t"
+         << ( (hits[0] == hits[1]) && (hits[1] == hits[2]) ? "PASS" : "FAIL" ) << endl;
+    delete tree;
+    linkedImage.close();
+    flatImage.close();
+    image.close();
+    remove(LINKED_FILE);
+    remove(FLAT_FILE);
+    remove(DAMAGED_FILE);
+}
@@ -0,0 +1,108 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <array>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "binary_tree.h"
+#include "tree_reduce.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+typedef BinaryTree<ll> Tree;
+
+const ll MOD = 1000000007;
+
+// 2x2 matrix product modulo MOD: associative but not commutative, so it catches any reordering of the nodes.
+typedef array<ll, 4> Matrix;
+Matrix multiply(const Matrix &a, const Matrix &b) {
+    return Matrix{{(a[0] * b[0] + a[1] * b[2]) % MOD, (a[0] * b[1] + a[1] * b[3]) % MOD,
+                   (a[2] * b[0] + a[3] * b[2]) % MOD, (a[2] * b[1] + a[3] * b[3]) % MOD}};
+}
+
+typedef array<ll, 16> Histogram;
+
+int main() {
+    const int NODES = 1 << 21;
+    mt19937_64 generator(42);
+    Tree *root = nullptr;
+    for (int i = 0; i < NODES; ++i) {
+        ll value = static_cast<ll>(generator() % 1000000000);
+        Tree **link = &root;
+        while (*link) {
+            link = (value < (*link)->value) ? &(*link)->lChild : &(*link)->rChild;
+        }
+        *link = new Tree{value};
+    }
+
+    auto value = [](const Tree *node) {return node->value;};
+    auto one = [](const Tree *) {return 1LL;};
+    auto plus = [](ll a, ll b) {return a + b;};
+    auto maximum = [](ll a, ll b) {return max(a, b);};
+    auto toMatrix = [](const Tree *node) {return Matrix{{node->value % 7 + 1, 1, 1, 0}};};
+    auto toBucket = [](const Tree *node) {
+        Histogram h{};
+        ++h[node->value % 16];
+        return h;
+    };
+    auto addHistograms = [](Histogram a, const Histogram &b) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] += b[i];
+        }
+        return a;
+    };
+    const Matrix IDENTITY = {{1, 0, 0, 1}};
+
+    auto start = chrono::steady_clock::now();
+    const ll sum = treeFold(root, 0LL, value, plus);
+    const ll count = treeFold(root, 0LL, one, plus);
+    const ll largest = treeFold(root, -1LL, value, maximum);
+    const Matrix product = treeFold(root, IDENTITY, toMatrix, multiply);
+    const Histogram histogram = treeFold(root, Histogram{}, toBucket, addHistograms);
+    chrono::duration<double, milli> sequentialMs = chrono::steady_clock::now() - start;
+    cout << "sequential in-order folds: " << sequentialMs.count() << " ms\n";
+
+    cout << "threads\tms\tspeedup\tmatches treeFold\n";
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        ForkJoinPool pool(threads);
+        start = chrono::steady_clock::now();
+        bool same = (parallelTreeReduce(pool, root, 0LL, value, plus) == sum);
+        same = same && (parallelTreeReduce(pool, root, 0LL, one, plus) == count);
+        same = same && (parallelTreeReduce(pool, root, -1LL, value, maximum) == largest);
+        same = same && (parallelTreeReduce(pool, root, IDENTITY, toMatrix, multiply) == product);
+        same = same && (parallelTreeReduce(pool, root, Histogram{}, toBucket, addHistograms) == histogram);
+        chrono::duration<double, milli> ms = chrono::steady_clock::now() - start;
+        cout << threads << "\t" << ms.count() << "\t" << sequentialMs.count() / ms.count() << "\t"
+             << (same ? "PASS" : "FAIL") << endl;
+    }
+
+    // Cutoffs at the extremes: everything sequential, and a task for every node of a small tree.
+    ForkJoinPool pool(4);
+    bool extremes = (parallelTreeReduce(pool, root, IDENTITY, toMatrix, multiply, 0) == product);
+    Tree *small = new Tree{4, new Tree{2, new Tree{1}, new Tree{3}}, new Tree{6, new Tree{5}, nullptr}};
+    extremes = extremes && (parallelTreeReduce(pool, small, 0LL, value, plus, 64) == 21);
+    extremes = extremes && (parallelTreeReduce(pool, static_cast<Tree *>(nullptr), 0LL, value, plus) == 0);
+    cout << "Fork depth 0, fork depth 64 and empty tree --> " << (extremes ? "PASS" : "FAIL") << endl;
+    delete small;
+    delete root;
+}
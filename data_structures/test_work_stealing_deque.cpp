@@ -0,0 +1,91 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "work_stealing_deque.h"
+
+using namespace std;
+using namespace vvalgo;
+
+typedef long long ll;
+
+int main() {
+    WorkStealingDeque<ll> deque(2); // Tiny, so that growing is exercised.
+    for (ll i = 0; i < 5; ++i) {
+        deque.push(i);
+    }
+    ll item = -1;
+    deque.pop(item);
+    cout << "owner pops the newest --> " << item << endl;
+    deque.steal(item);
+    cout << "thief steals the oldest --> " << item << endl;
+    while (deque.pop(item)) {
+        cout << item << " ";
+    }
+    cout << "\nempty --> " << (deque.is_empty() ? "yes" : "no") << endl;
+    
+    // The owner pushes n items and pops some of them back while thieves steal. Every item must be taken
+    // exactly once.
+    const ll n = 1000000;
+    for (int thieves = 1; thieves <= 8; thieves *= 2) {
+        WorkStealingDeque<ll> shared;
+        atomic<bool> ownerDone(false);
+        vector<vector<ll> > taken(thieves + 1);
+        vector<thread> threads;
+        for (int t = 1; t <= thieves; ++t) {
+            threads.emplace_back([&, t]() {
+                ll stolen;
+                while (!ownerDone.load() || !shared.is_empty()) {
+                    if (shared.steal(stolen)) {
+                        taken[t].push_back(stolen);
+                    }
+                }
+            });
+        }
+        ll popped;
+        for (ll i = 0; i < n; ++i) {
+            shared.push(i);
+            if ( (i % 4 == 0) && shared.pop(popped) ) {
+                taken[0].push_back(popped);
+            }
+        }
+        while (shared.pop(popped)) {
+            taken[0].push_back(popped);
+        }
+        ownerDone.store(true);
+        for (auto &t : threads) {
+            t.join();
+        }
+        vector<ll> all;
+        for (auto &t : taken) {
+            all.insert(all.end(), t.begin(), t.end());
+        }
+        sort(all.begin(), all.end());
+        bool exactlyOnce = (all.size() == static_cast<size_t>(n));
+        for (ll i = 0; exactlyOnce && i < n; ++i) {
+            exactlyOnce = (all[i] == i);
+        }
+        cout << thieves << " thieves: every item taken exactly once --> " << (exactlyOnce ? "PASS" : "FAIL")
+             << " (" << (n - static_cast<ll>(taken[0].size())) << " stolen)" << endl;
+    }
+}
@@ -0,0 +1,407 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_TREE_IMAGE_H
+#define APFN_DATA_STRUCTURES_TREE_IMAGE_H
+
+#include <cstddef>      // size_t
+#include <cstdint>      // Fixed-size header fields.
+#include <cstdio>       // Writing images.
+#include <cstring>      // std::memcmp, std::memcpy, std::memset
+#include <type_traits>  // std::is_trivially_copyable
+#include <utility>      // std::declval, std::pair
+#include <vector>       // Records in preorder.
+
+#include <fcntl.h>      // Mapping images: POSIX only.
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tree_traversal.h"
+#include "flat_search_tree.h"
+
+namespace vvalgo {
+
+    /*
+     * A tree image is a file that holds a tree's values and shape, and that TreeImage maps into memory and
+     * searches where it lies: opening one costs a system call, not a rebuild, and pages are read as lookups
+     * touch them.
+     *
+     *     header      64 bytes, below.
+     *     payload     LINKED: size records {value, left, right}, in preorder from the root at 0. Children
+     *                 are record numbers, NO_CHILD for none, so the file means the same wherever it is mapped.
+     *                 EYTZINGER: the slots of a FlatSearchTree, unused slot 0 included, so that slot k is at
+     *                 payload + k * sizeof(value) and keeps its cache line alignment.
+     *
+     * Values are stored as their bytes, so ValueType must be trivially copyable and the file can only be read
+     * on a machine with the same byte order and type layout; the header records enough of both to refuse any
+     * other. An optional 64-bit checksum of the payload catches torn or corrupted files. Any change to the
+     * layout or the checksum bumps VERSION.
+     */
+    namespace image_detail {
+        const char MAGIC[8] = {'V', 'V', 'T', 'R', 'E', 'E', 'I', 'M'};
+        const uint32_t ORDER_MARK = 0x01020304;
+        const uint32_t VERSION = 2;   // 2: a checksum that mixes high bits down, in place of FNV-1a on words.
+        const uint32_t LINKED = 1;
+        const uint32_t EYTZINGER = 2;
+        const uint32_t HAS_CHECKSUM = 1;
+        const uint32_t NO_CHILD = 0xFFFFFFFF;
+
+        struct Header {
+            char magic[8];
+            uint32_t byteOrder;     // ORDER_MARK as the writer saw it.
+            uint32_t version;
+            uint32_t layout;        // LINKED or EYTZINGER.
+            uint32_t valueBytes;    // sizeof(ValueType).
+            uint32_t recordBytes;   // Bytes per record or slot in the payload.
+            uint32_t flags;
+            uint64_t count;         // Values in the tree.
+            uint64_t payloadBytes;
+            uint64_t checksum;      // 0 without HAS_CHECKSUM.
+            uint64_t reserved;
+        };
+        static_assert(sizeof(Header) == 64, "The payload starts on a cache line");
+
+        template <typename ValueType>
+        struct Record {
+            ValueType value;
+            uint32_t left;
+            uint32_t right;
+        };
+
+        // Works on whole words, so that checking a large image runs at memory speed. Feed it 8 bytes at a time
+        // except at the very end. A multiply only carries a change towards the high bits, so each step folds
+        // the top half back down with an xor-shift; without that (FNV-1a on words), flipping bit 63 of any two
+        // words left the result unchanged. Every step is a bijection of the state, so a change in one word is
+        // never lost, and value() runs the state through a final mix.
+        class Checksum {
+        public:
+            Checksum() : hash(0xcbf29ce484222325ULL) {}
+
+            void add(const unsigned char *bytes, size_t n) {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    uint64_t word;
+                    std::memcpy(&word, bytes + i, 8);
+                    mix(word);
+                }
+                for (; i < n; ++i) {
+                    mix(bytes[i]);
+                }
+            }
+
+            uint64_t value() const {
+                uint64_t h = hash;
+                h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+                return h ^ (h >> 31);
+            }
+
+        private:
+            void mix(uint64_t word) {
+                hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+                hash ^= hash >> 32;
+            }
+
+            uint64_t hash;
+        }; // CS : Checksum
+
+        // Buffers the payload on its way to the file, checksumming it as it goes. The header goes in last.
+        class Output {
+        public:
+            explicit Output(const char *p) : path(p), file(std::fopen(p, "wb")), used(0), written(0), ok(file != nullptr) {
+                Header blank;
+                std::memset(&blank, 0, sizeof(blank));
+                ok = ok && (std::fwrite(&blank, sizeof(blank), 1, file) == 1);
+            }
+
+            ~Output() {
+                if (file) {
+                    std::fclose(file);
+                    std::remove(path); // Never finished.
+                }
+            }
+
+            void write(const void *bytes, size_t n) {
+                const unsigned char *from = static_cast<const unsigned char *>(bytes);
+                while (ok && n) {
+                    size_t chunk = (n < sizeof(buffer) - used) ? n : sizeof(buffer) - used;
+                    std::memcpy(buffer + used, from, chunk);
+                    used += chunk, from += chunk, n -= chunk;
+                    if (used == sizeof(buffer)) {
+                        flush();
+                    }
+                }
+            }
+
+            bool finish(Header header, bool checksum) {
+                if (!file) {
+                    return false;
+                }
+                flush();
+                header.payloadBytes = written;
+                header.flags = checksum ? HAS_CHECKSUM : 0;
+                header.checksum = checksum ? sum.value() : 0;
+                ok = ok && !std::fseek(file, 0, SEEK_SET) && (std::fwrite(&header, sizeof(header), 1, file) == 1);
+                ok = !std::fclose(file) && ok;
+                file = nullptr;
+                if (!ok) {
+                    std::remove(path);
+                }
+                return ok;
+            }
+
+        private:
+            void flush() {
+                sum.add(buffer, used); // Every chunk but the last is a whole number of words.
+                ok = ok && (std::fwrite(buffer, 1, used, file) == used);
+                written += used;
+                used = 0;
+            }
+
+            const char *path;
+            std::FILE *file;
+            unsigned char buffer[1 << 16];
+            size_t used;
+            uint64_t written;
+            Checksum sum;
+            bool ok;
+        }; // CS : Output
+
+        template <typename ValueType>
+        Header header(uint32_t layout, uint32_t recordBytes, uint64_t count) {
+            static_assert(std::is_trivially_copyable<ValueType>::value, "Images hold values as raw bytes");
+            Header h;
+            std::memset(&h, 0, sizeof(h));
+            std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+            h.byteOrder = ORDER_MARK;
+            h.version = VERSION;
+            h.layout = layout;
+            h.valueBytes = sizeof(ValueType);
+            h.recordBytes = recordBytes;
+            h.count = count;
+            return h;
+        }
+    } // NS : image_detail
+
+    /*
+     * Writes the tree at root (RBTree, BST nodes, BinaryTree: anything tree_traversal.h can walk) as a LINKED
+     * image at path, shape and all. Returns false, and leaves no file behind, if the file cannot be written or
+     * the tree has more nodes than 32-bit record numbers can reach.
+     */
+    template <typename Node>
+    bool writeTreeImage(const char *path, Node *root, bool checksum = true) {
+        typedef typename std::decay<decltype(std::declval<Node &>().value)>::type ValueType;
+        typedef image_detail::Record<ValueType> Record;
+        // Preorder, so a node's number is its place in records, and a left child is the next record. A right
+        // child's number is only known when it is reached, so its parent's record waits in memory until then.
+        std::vector<Record> records;
+        Stack<std::pair<Node *, size_t>, tree_detail::INLINE_DEPTH> pending; // A right child and its parent's number.
+        Node *node = root;
+        size_t parent = image_detail::NO_CHILD;
+        while (node || !pending.is_empty()) {
+            if (!node) {
+                std::pair<Node *, size_t> next(nullptr, 0);
+                pending.pop(next);
+                node = next.first;
+                parent = next.second;
+                records[parent].right = static_cast<uint32_t>(records.size());
+            }
+            if (records.size() + 1 >= image_detail::NO_CHILD) {
+                return false;
+            }
+            Record record;
+            std::memset(&record, 0, sizeof(record)); // No stray padding bytes in the file or the checksum.
+            record.value = node->value;
+            record.left = record.right = image_detail::NO_CHILD;
+            records.push_back(record);
+            size_t number = records.size() - 1;
+            if (Node *r = tree_detail::right(node)) {
+                pending.push(std::make_pair(r, number));
+            }
+            node = tree_detail::left(node);
+            if (node) {
+                records[number].left = static_cast<uint32_t>(number + 1);
+            }
+        }
+        image_detail::Output out(path);
+        out.write(records.data(), records.size() * sizeof(Record));
+        return out.finish(image_detail::header<ValueType>(image_detail::LINKED, sizeof(Record), records.size()),
+                          checksum);
+    }
+
+    // Writes a flattened tree as an EYTZINGER image.
+    template <typename ValueType>
+    bool writeTreeImage(const char *path, const FlatSearchTree<ValueType> &flat, bool checksum = true) {
+        image_detail::Output out(path);
+        out.write(flat.slotArray(), (flat.size() + 1) * sizeof(ValueType));
+        return out.finish(image_detail::header<ValueType>(image_detail::EYTZINGER, sizeof(ValueType), flat.size()),
+                          checksum);
+    }
+
+    /*
+     * A tree image mapped read-only into memory. open() checks the header against ValueType and the file size,
+     * and with verify also the checksum and every child number, which reads the whole file; without verify the
+     * file is trusted, and opening costs the same for any size. find() and lowerBound() search images of search
+     * trees (LINKED from an RBTree or BST, or EYTZINGER), and root(), left() and right() walk any LINKED image.
+     * Pointers into the image stay valid until close().
+     */
+    template <typename ValueType>
+    class TreeImage {
+    public:
+        typedef image_detail::Record<ValueType> Record;
+
+        TreeImage() : mapping(nullptr), mappedBytes(0), header(nullptr), records(nullptr), slots(nullptr) {}
+        ~TreeImage() {close();}
+
+        TreeImage(const TreeImage &) = delete;
+        TreeImage &operator=(const TreeImage &) = delete;
+
+        bool open(const char *path, bool verify = true) {
+            close();
+            int fd = ::open(path, O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+            struct stat status;
+            bool ok = !fstat(fd, &status) && (static_cast<size_t>(status.st_size) >= sizeof(image_detail::Header));
+            if (ok) {
+                mappedBytes = static_cast<size_t>(status.st_size);
+                mapping = mmap(nullptr, mappedBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+                ok = (mapping != MAP_FAILED);
+                if (!ok) {
+                    mapping = nullptr;
+                }
+            }
+            ::close(fd); // The mapping keeps the file.
+            if (!ok || !accept(verify)) {
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        void close() {
+            if (mapping) {
+                munmap(mapping, mappedBytes);
+            }
+            mapping = nullptr;
+            mappedBytes = 0;
+            header = nullptr;
+            records = nullptr;
+            slots = nullptr;
+        }
+
+        bool isOpen() const {return header != nullptr;}
+        bool isFlat() const {return slots != nullptr;}
+        size_t size() const {return header ? static_cast<size_t>(header->count) : 0;}
+
+        // The records of a LINKED image. All null for an EYTZINGER one.
+        const Record *root() const {return (records && header->count) ? records : nullptr;}
+        const Record *left(const Record *record) const {return child(record->left);}
+        const Record *right(const Record *record) const {return child(record->right);}
+
+        // The smallest value not less than val, or null if there is none.
+        const ValueType *lowerBound(const ValueType &val) const {
+            if (slots) {
+                size_t k = eytzinger_detail::lowerBound(slots, size(), val);
+                return k ? &slots[k] : nullptr;
+            }
+            const ValueType *bound = nullptr;
+            for (const Record *record = root(); record; ) {
+                if (record->value < val) {
+                    record = right(record);
+                } else {
+                    bound = &record->value;
+                    record = left(record);
+                }
+            }
+            return bound;
+        }
+
+        // The value equal to val, or null.
+        const ValueType *find(const ValueType &val) const {
+            const ValueType *bound = lowerBound(val);
+            return (bound && !(val < *bound)) ? bound : nullptr;
+        }
+
+    private:
+        const Record *child(uint32_t number) const {
+            return (number == image_detail::NO_CHILD) ? nullptr : records + number;
+        }
+
+        bool accept(bool verify) {
+            using namespace image_detail;
+            const Header *h = static_cast<const Header *>(mapping);
+            const unsigned char *payload = static_cast<const unsigned char *>(mapping) + sizeof(Header);
+            size_t payloadBytes = mappedBytes - sizeof(Header);
+            if ( std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) || (h->byteOrder != ORDER_MARK) ||
+                 (h->version != VERSION) || (h->valueBytes != sizeof(ValueType)) || (h->payloadBytes != payloadBytes) ) {
+                return false;
+            }
+            if (h->layout == LINKED) {
+                if ( (h->recordBytes != sizeof(Record)) || (h->count >= NO_CHILD) || (payloadBytes % sizeof(Record)) ||
+                     (h->count != payloadBytes / sizeof(Record)) ) {
+                    return false;
+                }
+            } else if (h->layout == EYTZINGER) {
+                if ( (h->recordBytes != sizeof(ValueType)) || (payloadBytes % sizeof(ValueType)) ||
+                     (h->count + 1 != payloadBytes / sizeof(ValueType)) ) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+            if (verify) {
+                if (h->flags & HAS_CHECKSUM) {
+                    Checksum sum;
+                    sum.add(payload, payloadBytes);
+                    if (sum.value() != h->checksum) {
+                        return false;
+                    }
+                }
+                if (h->layout == LINKED) { // Children come after their parent, so walks always end.
+                    const Record *all = reinterpret_cast<const Record *>(payload);
+                    for (uint64_t i = 0; i < h->count; ++i) {
+                        for (uint32_t c : {all[i].left, all[i].right}) {
+                            if ( (c != NO_CHILD) && ((c <= i) || (c >= h->count)) ) {
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+            header = h;
+            if (h->layout == LINKED) {
+                records = reinterpret_cast<const Record *>(payload);
+            } else {
+                slots = reinterpret_cast<const ValueType *>(payload);
+            }
+            return true;
+        }
+
+        void *mapping;
+        size_t mappedBytes;
+        const image_detail::Header *header;
+        const Record *records;      // LINKED images.
+        const ValueType *slots;     // EYTZINGER images: slots[1] to slots[size()].
+    }; // CS : TreeImage
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_TREE_IMAGE_H
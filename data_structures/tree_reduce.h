@@ -0,0 +1,90 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_TREE_REDUCE_H
+#define APFN_DATA_STRUCTURES_TREE_REDUCE_H
+
+#include <cstddef>  // size_t
+
+#include "tree_traversal.h"
+#include "fork_join_pool.h"
+
+namespace vvalgo {
+
+    /*
+     * In-order fold: combine(...combine(combine(identity, map(n1)), map(n2))..., map(nk)) over the nodes n1..nk
+     * of the tree in in-order. map() turns a node into a Result and combine() must be associative, with identity
+     * as its identity element.
+     */
+    template <typename T, typename Result, typename Map, typename Combine>
+    Result treeFold(T *root, Result identity, Map map, Combine combine) {
+        Result result = identity;
+        for (auto &node : inorder(root)) {
+            result = combine(result, map(&node));
+        }
+        return result;
+    } // FN : treeFold
+
+    namespace tree_detail {
+        template <typename T, typename Result, typename Map, typename Combine>
+        Result parallelReduce(ForkJoinPool &pool, T *node, const Result &identity, Map &map, Combine &combine,
+                              size_t depthLeft) {
+            if (!node) {
+                return identity;
+            }
+            if (!depthLeft) {
+                return treeFold(node, identity, map, combine);
+            }
+            Result l = identity, r = identity;
+            pool.invoke([&]() {l = parallelReduce(pool, left(node), identity, map, combine, depthLeft - 1);},
+                        [&]() {r = parallelReduce(pool, right(node), identity, map, combine, depthLeft - 1);});
+            return combine(combine(l, map(node)), r); // Left, node, right: the in-order sequence, merely regrouped.
+        }
+    } // NS : tree_detail
+
+    /*
+     * Parallel version of treeFold(). The top forkDepth levels of the tree are split into tasks on the pool, one
+     * per subtree, and everything below is folded sequentially by whichever worker picks the subtree up. Each
+     * node's result is combined as left subtree, node, right subtree, which is the in-order sequence grouped
+     * differently, so for an associative combine() the result is identical to treeFold() even when combine() is
+     * not commutative.
+     *
+     * The default forkDepth makes about eight tasks per worker on a balanced tree, so stealing can even out
+     * subtrees of different sizes. Subtrees that are empty or tiny cost a task each, and a degenerate tree gets
+     * no parallelism at all, but nothing worse than the sequential fold.
+     */
+    template <typename T, typename Result, typename Map, typename Combine>
+    Result parallelTreeReduce(ForkJoinPool &pool, T *root, Result identity, Map map, Combine combine,
+                              size_t forkDepth) {
+        Result result = identity;
+        pool.run([&]() {result = tree_detail::parallelReduce(pool, root, identity, map, combine, forkDepth);});
+        return result;
+    } // FN : parallelTreeReduce
+
+    template <typename T, typename Result, typename Map, typename Combine>
+    Result parallelTreeReduce(ForkJoinPool &pool, T *root, Result identity, Map map, Combine combine) {
+        size_t forkDepth = 3; // 2^3 tasks for a single worker.
+        for (int tasks = 1; tasks < pool.threadCount(); tasks *= 2) {
+            ++forkDepth;
+        }
+        return parallelTreeReduce(pool, root, identity, map, combine, forkDepth);
+    } // FN : parallelTreeReduce
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_TREE_REDUCE_H
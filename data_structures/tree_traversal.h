@@ -0,0 +1,526 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_TREE_TRAVERSAL_H
+#define APFN_DATA_STRUCTURES_TREE_TRAVERSAL_H
+
+#include <cstddef>      // std::ptrdiff_t
+#include <deque>        // Level-order frontier.
+#include <iterator>     // std::forward_iterator_tag
+#include <type_traits>  // std::remove_const
+
+#include "stack.h"
+
+namespace vvalgo {
+
+    /*
+     * TreeLinks tells the traversal code where a node keeps its children. The default works for nodes with
+     * public left and right members (RBTree). Node types that name them differently (BinaryTree uses lChild and
+     * rChild) specialize it next to their definition.
+     *
+     * left() and right() return a reference to the member so that code which rewires the tree can assign
+     * through them. On a const node the reference is const.
+     */
+    template <typename Node>
+    struct TreeLinks {
+        template <typename N>
+        static auto left(N *node) -> decltype((node->left)) {return node->left;}
+        template <typename N>
+        static auto right(N *node) -> decltype((node->right)) {return node->right;}
+    };
+
+    namespace tree_detail {
+        template <typename Node>
+        auto left(Node *node) -> decltype(TreeLinks<typename std::remove_const<Node>::type>::left(node)) {
+            return TreeLinks<typename std::remove_const<Node>::type>::left(node);
+        }
+
+        template <typename Node>
+        auto right(Node *node) -> decltype(TreeLinks<typename std::remove_const<Node>::type>::right(node)) {
+            return TreeLinks<typename std::remove_const<Node>::type>::right(node);
+        }
+
+        // Enough for any balanced tree that fits in memory. Deeper (degenerate) trees spill onto the heap.
+        const size_t INLINE_DEPTH = 32;
+    } // NS : tree_detail
+
+    /*
+     * Forward iterators over the nodes of a tree. Each one keeps the path it still has to come back to on an
+     * explicit Stack, so walking a degenerate tree (a BST built from sorted input is a linked list) can never
+     * overflow the call stack, and no heap memory is touched unless the tree is deeper than INLINE_DEPTH.
+     * A default constructed iterator is the end iterator.
+     *
+     *     for (auto &node : inorder(root)) {
+     *         if (node.value == wanted) {
+     *             break;
+     *         }
+     *     }
+     *
+     * The tree must not be modified while it is being iterated.
+     */
+    template <typename Node>
+    class InorderIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Node value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Node *pointer;
+        typedef Node &reference;
+
+        InorderIterator() {}
+        explicit InorderIterator(Node *root) {pushLeftSpine(root);}
+
+        reference operator*() const {return *path.top();}
+        pointer operator->() const {return path.top();}
+
+        InorderIterator &operator++() {
+            Node *node = path.top();
+            path.pop();
+            pushLeftSpine(tree_detail::right(node));
+            return *this;
+        }
+
+        InorderIterator operator++(int) {
+            InorderIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        // Every node shows up once in the sequence, so the current node identifies the position.
+        bool operator==(const InorderIterator &other) const {return current() == other.current();}
+        bool operator!=(const InorderIterator &other) const {return current() != other.current();}
+
+    private:
+        void pushLeftSpine(Node *node) {
+            for (; node; node = tree_detail::left(node)) {
+                path.push(node);
+            }
+        }
+
+        Node *current() const {return path.is_empty() ? nullptr : path.top();}
+
+        Stack<Node *, tree_detail::INLINE_DEPTH> path; // The current node and the ancestors still to be visited.
+    }; // CS : InorderIterator
+
+    template <typename Node>
+    class PreorderIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Node value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Node *pointer;
+        typedef Node &reference;
+
+        PreorderIterator() {}
+        explicit PreorderIterator(Node *root) {
+            if (root) {
+                pending.push(root);
+            }
+        }
+
+        reference operator*() const {return *pending.top();}
+        pointer operator->() const {return pending.top();}
+
+        PreorderIterator &operator++() {
+            Node *node = pending.top();
+            pending.pop();
+            if (tree_detail::right(node)) {
+                pending.push(tree_detail::right(node));
+            }
+            if (tree_detail::left(node)) {
+                pending.push(tree_detail::left(node));
+            }
+            return *this;
+        }
+
+        PreorderIterator operator++(int) {
+            PreorderIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const PreorderIterator &other) const {return current() == other.current();}
+        bool operator!=(const PreorderIterator &other) const {return current() != other.current();}
+
+    private:
+        Node *current() const {return pending.is_empty() ? nullptr : pending.top();}
+
+        // Right subtrees we have yet to visit, one per level at most, with the current node on top.
+        Stack<Node *, tree_detail::INLINE_DEPTH> pending;
+    }; // CS : PreorderIterator
+
+    template <typename Node>
+    class PostorderIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Node value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Node *pointer;
+        typedef Node &reference;
+
+        PostorderIterator() {}
+        explicit PostorderIterator(Node *root) {descend(root);}
+
+        reference operator*() const {return *path.top();}
+        pointer operator->() const {return path.top();}
+
+        // The node after a left child is the first node of its right sibling's subtree, if there is one, or
+        // else the parent. The node after a right child is always the parent.
+        PostorderIterator &operator++() {
+            Node *child = path.top();
+            path.pop();
+            if (!path.is_empty()) {
+                Node *parent = path.top();
+                if ( (tree_detail::left(parent) == child) && tree_detail::right(parent) ) {
+                    descend(tree_detail::right(parent));
+                }
+            }
+            return *this;
+        }
+
+        PostorderIterator operator++(int) {
+            PostorderIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const PostorderIterator &other) const {return current() == other.current();}
+        bool operator!=(const PostorderIterator &other) const {return current() != other.current();}
+
+    private:
+        // Walks down to the first node of the subtree in post-order, preferring left children to right ones.
+        void descend(Node *node) {
+            while (node) {
+                path.push(node);
+                node = tree_detail::left(node) ? tree_detail::left(node) : tree_detail::right(node);
+            }
+        }
+
+        Node *current() const {return path.is_empty() ? nullptr : path.top();}
+
+        Stack<Node *, tree_detail::INLINE_DEPTH> path; // The current node and all of its ancestors.
+    }; // CS : PostorderIterator
+
+    /*
+     * Level-order needs a whole level of the tree in hand rather than a path, so its frontier is a deque and
+     * does allocate. Copying the iterator copies the frontier.
+     */
+    template <typename Node>
+    class LevelorderIterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Node value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Node *pointer;
+        typedef Node &reference;
+
+        LevelorderIterator() {}
+        explicit LevelorderIterator(Node *root) {
+            if (root) {
+                frontier.push_back(root);
+            }
+        }
+
+        reference operator*() const {return *frontier.front();}
+        pointer operator->() const {return frontier.front();}
+
+        LevelorderIterator &operator++() {
+            Node *node = frontier.front();
+            frontier.pop_front();
+            if (tree_detail::left(node)) {
+                frontier.push_back(tree_detail::left(node));
+            }
+            if (tree_detail::right(node)) {
+                frontier.push_back(tree_detail::right(node));
+            }
+            return *this;
+        }
+
+        LevelorderIterator operator++(int) {
+            LevelorderIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const LevelorderIterator &other) const {return current() == other.current();}
+        bool operator!=(const LevelorderIterator &other) const {return current() != other.current();}
+
+    private:
+        Node *current() const {return frontier.empty() ? nullptr : frontier.front();}
+
+        std::deque<Node *> frontier;
+    }; // CS : LevelorderIterator
+
+    // A begin/end pair so that traversals can be used in range-based for loops.
+    template <typename Iterator>
+    class TraversalRange {
+    public:
+        explicit TraversalRange(Iterator b) : first(b) {}
+        Iterator begin() const {return first;}
+        Iterator end() const {return Iterator();}
+    private:
+        Iterator first;
+    }; // CS : TraversalRange
+
+    template <typename Node>
+    TraversalRange<InorderIterator<Node> > inorder(Node *root) {
+        return TraversalRange<InorderIterator<Node> >(InorderIterator<Node>(root));
+    }
+
+    template <typename Node>
+    TraversalRange<PreorderIterator<Node> > preorder(Node *root) {
+        return TraversalRange<PreorderIterator<Node> >(PreorderIterator<Node>(root));
+    }
+
+    template <typename Node>
+    TraversalRange<PostorderIterator<Node> > postorder(Node *root) {
+        return TraversalRange<PostorderIterator<Node> >(PostorderIterator<Node>(root));
+    }
+
+    template <typename Node>
+    TraversalRange<LevelorderIterator<Node> > levelorder(Node *root) {
+        return TraversalRange<LevelorderIterator<Node> >(LevelorderIterator<Node>(root));
+    }
+
+    /*
+     * General traversal function. It invokes pre(), in() and post() callbacks in the pre-order, inorder
+     * and post-order traversal fashion.
+     *
+     * Important Points to Note:
+     * - On Callbacks: If we perform a particular traversal, we guarantee that the relevant callback will be executed.
+     * - On Traversal: Once a callback returns true, to indicate that the traversal can stop, we prevent further traversal.
+     *
+     * As a result of these two points, an interesting situation arises. If we have gone down the left
+     * subtree and some callback returns true, do we invoke the in() callback of the node? If we had gone
+     * down the right subtree and then a callback returned true, do we invoke the post() callback?
+     * The answer is, yes we do. This comes from the first of the two assurances we mentioned above. If
+     * we have performed a particular traversal, we will invoke the relevant callback.
+     *
+     * This has a very interesting repurcussions on the way you would write callbacks. Since all the pre() callbacks
+     * are called once we descend down a tree, pre() will never be invoked once any of the callbacks stops the traversal.
+     * in() is performed after the left subtree has been traversed (may be partially traversed if a callback stopped the
+     * traversal). This means, in() should be invoked regardless of whether or not further traversal has been cancelled.
+     * Similar situation applies for post(). Once we have traversed down the right subtree, we are obliged to invoke
+     * post() regardless of any indications related to stopping traversal.
+     *
+     * The recursion is unrolled onto an explicit stack of frames, each remembering which subtree of its node is
+     * being walked, so that the callbacks are invoked directly and degenerate trees cannot overflow the call stack.
+     */
+    template <typename T, typename U, typename V, typename W> // TIP: Always use different typenames for template arguments.
+    void traverse(T *root, U pre, V in, W post) {
+        enum Side : unsigned char {WALKING_LEFT, WALKING_RIGHT};
+        struct Frame {
+            T *node;
+            Side side;
+        };
+        Stack<Frame, tree_detail::INLINE_DEPTH> frames;
+        bool stopTraversal = false;
+        T *node = root;
+        while (true) {
+            for (; node; node = tree_detail::left(node)) { // Descend, doing the pre-order processing on the way down.
+                if (pre(node)) {
+                    stopTraversal = true;
+                    break;
+                }
+                frames.push(Frame{node, WALKING_LEFT});
+            }
+            node = nullptr;
+            if (frames.is_empty()) {
+                return;
+            }
+
+            Frame &frame = frames.top();
+            if (frame.side == WALKING_LEFT) {   // Done with the left subtree.
+                if (in(frame.node)) {           // Perform inorder processing.
+                    stopTraversal = true;
+                }
+                if (stopTraversal) {            // Skip the right subtree and the post-order processing.
+                    frames.pop();
+                } else {
+                    frame.side = WALKING_RIGHT;
+                    node = tree_detail::right(frame.node);
+                }
+            } else {                            // Done with the right subtree.
+                T *done = frame.node;
+                frames.pop();
+                if (post(done)) {               // Perform post-order processing.
+                    stopTraversal = true;
+                }
+            }
+        }
+    }
+
+    /*
+     * Expected signature for foo(): bool (*)(T *); // return true if you have accomplished your goal and want traversal to stop prematurely.
+     *
+     * It is our responsibility to ensure that foo() is never called once it has returned true. This way,
+     * all the complexity related to ensuring this behavior lies within the traversal code rather than being spread
+     * out among all the implementations of foo(). This will result in less bugs in the system by reducing the
+     * number of code-paths to be tested.
+     */
+    template <typename T, typename V>
+    void inorderTraverse(T *root, V foo) {
+        for (auto &node : inorder(root)) {
+            if (foo(&node)) {
+                break;
+            }
+        }
+    } // FN : inorderTraverse
+
+    template <typename T, typename V>
+    void preorderTraverse(T *root, V foo) {
+        for (auto &node : preorder(root)) {
+            if (foo(&node)) {
+                break;
+            }
+        }
+    } // FN : preorderTraverse
+
+    template <typename T, typename V>
+    void postorderTraverse(T *root, V foo) {
+        for (auto &node : postorder(root)) {
+            if (foo(&node)) {
+                break;
+            }
+        }
+    } // FN : postorderTraverse
+
+    template <typename T, typename V>
+    void levelorderTraverse(T *root, V foo) {
+        for (auto &node : levelorder(root)) {
+            if (foo(&node)) {
+                break;
+            }
+        }
+    } // FN : levelorderTraverse
+
+    /*
+     * Deletes the tree at node, whose nodes were made with new, for the destructors of the node types. Deleting
+     * the children recursively takes as many stack frames as the tree is deep, and a BST built from sorted
+     * input is as deep as it is large. Instead, rotate left children up until the node has none, then delete
+     * it and move on down its right spine. Every node is rotated at most once, and no memory is needed. The
+     * rotations leave augmentation (sizes, maxHigh) stale, which does not matter to nodes about to go.
+     */
+    template <typename Node>
+    void deleteSubtree(Node *node) {
+        while (node) {
+            if (tree_detail::left(node)) {
+                Node *l = tree_detail::left(node);
+                tree_detail::left(node) = tree_detail::right(l);
+                tree_detail::right(l) = node;
+                node = l;
+            } else {
+                Node *next = tree_detail::right(node);
+                tree_detail::right(node) = nullptr; // The destructor of node has nothing left to do.
+                delete node;
+                node = next;
+            }
+        }
+    } // FN : deleteSubtree
+
+    /*
+     * Morris traversals visit the same nodes in the same order as inorderTraverse() and preorderTraverse(), with
+     * the same callback contract, but use O(1) extra memory however deep the tree is. They find their way back
+     * up by temporarily pointing the empty right link of each in-order predecessor at the node to return to
+     * (a "thread"), and remove every thread on the second visit. The price is walking each left subtree's right
+     * spine twice, and the tree being modified while the walk is in progress, so nobody else may read it.
+     *
+     * If foo() asks to stop, the walk carries on without calling foo() until the last thread is gone, so the
+     * tree is always left exactly as it was found. Every live thread leads back to an ancestor of the current
+     * node, so none is inside a left subtree not entered yet: those are skipped, and stopping early costs about
+     * the climb back out rather than the rest of the tree.
+     */
+    template <typename T, typename V>
+    void morrisInorderTraverse(T *root, V foo) {
+        bool stopTraversal = false;
+        size_t threads = 0;
+        T *node = root;
+        while (node) {
+            if (stopTraversal && !threads) {
+                return;
+            }
+            if (!tree_detail::left(node)) {
+                if (!stopTraversal && foo(node)) {
+                    stopTraversal = true;
+                }
+                node = tree_detail::right(node); // Either the right subtree or a thread back up.
+                continue;
+            }
+            T *predecessor = tree_detail::left(node);
+            while (tree_detail::right(predecessor) && (tree_detail::right(predecessor) != node)) {
+                predecessor = tree_detail::right(predecessor);
+            }
+            if (!tree_detail::right(predecessor)) {  // First visit: thread back to node and walk the left subtree.
+                if (stopTraversal) {
+                    node = tree_detail::right(node);
+                    continue;
+                }
+                tree_detail::right(predecessor) = node;
+                ++threads;
+                node = tree_detail::left(node);
+            } else {                                // Back from the left subtree: remove the thread.
+                tree_detail::right(predecessor) = nullptr;
+                --threads;
+                if (!stopTraversal && foo(node)) {
+                    stopTraversal = true;
+                }
+                node = tree_detail::right(node);
+            }
+        }
+    } // FN : morrisInorderTraverse
+
+    template <typename T, typename V>
+    void morrisPreorderTraverse(T *root, V foo) {
+        bool stopTraversal = false;
+        size_t threads = 0;
+        T *node = root;
+        while (node) {
+            if (stopTraversal && !threads) {
+                return;
+            }
+            if (!tree_detail::left(node)) {
+                if (!stopTraversal && foo(node)) {
+                    stopTraversal = true;
+                }
+                node = tree_detail::right(node);
+                continue;
+            }
+            T *predecessor = tree_detail::left(node);
+            while (tree_detail::right(predecessor) && (tree_detail::right(predecessor) != node)) {
+                predecessor = tree_detail::right(predecessor);
+            }
+            if (!tree_detail::right(predecessor)) {  // First visit is the pre-order one.
+                if (stopTraversal || foo(node)) {
+                    stopTraversal = true;
+                    node = tree_detail::right(node);
+                    continue;
+                }
+                tree_detail::right(predecessor) = node;
+                ++threads;
+                node = tree_detail::left(node);
+            } else {
+                tree_detail::right(predecessor) = nullptr;
+                --threads;
+                node = tree_detail::right(node);
+            }
+        }
+    } // FN : morrisPreorderTraverse
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_TREE_TRAVERSAL_H
@@ -0,0 +1,143 @@
+/*
+ *  Vivandro's algorithm prep material.
+ *  Copyright (C) 2014 Vivandro. All rights reserved.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APFN_DATA_STRUCTURES_WORK_STEALING_DEQUE_H
+#define APFN_DATA_STRUCTURES_WORK_STEALING_DEQUE_H
+
+#include <atomic>       // std::atomic for the indices and the slots.
+#include <vector>       // Retired buffers.
+#include <memory>       // std::unique_ptr
+#include <type_traits>  // std::is_trivially_copyable
+
+namespace vvalgo {
+
+/*
+ * WorkStealingDeque is the Chase-Lev deque, with the memory orderings of Le, Pop, Cohen and Zappa Nardelli
+ * ("Correct and efficient work-stealing for weak memory models").
+ * - Exactly one thread, the owner, calls push() and pop(). Both work at the bottom, so the owner sees its
+ *   own work in LIFO order, which is what keeps a recursive computation cache friendly.
+ * - Any other thread may call steal(), which takes from the top: the oldest, and for divide and conquer
+ *   usually the largest, piece of work.
+ * The owner only synchronizes with thieves when the deque is down to its last item.
+ *
+ * The items live in a circular buffer that doubles when full. Old buffers are kept until the deque is
+ * destroyed because a slow thief may still be reading from one. They add up to less than the live buffer.
+ *
+ * T has to be trivially copyable (typically a pointer to a task) since the slots are atomics.
+ */
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque needs a trivially copyable T");
+    
+public:
+    WorkStealingDeque(long long initialCapacity = 1024) : top(0), bottom(0) {
+        long long capacity = 1;
+        while (capacity < initialCapacity) { // Power of two, so that the index wraps with a mask.
+            capacity *= 2;
+        }
+        buffers.emplace_back(new Buffer(capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+    
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+    
+    // Owner only.
+    void push(T item) {
+        long long b = bottom.load(std::memory_order_relaxed);
+        long long t = top.load(std::memory_order_acquire);
+        Buffer *a = buffer.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) { // Full.
+            a = grow(a, b, t);
+        }
+        a->put(b, item);
+        bottom.store(b + 1, std::memory_order_release); // Publishes the item (and whatever it points to) to thieves.
+    }
+    
+    // Owner only. Takes the most recently pushed item. Returns false if the deque is empty.
+    bool pop(T &item) {
+        long long b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer *a = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long t = top.load(std::memory_order_relaxed);
+        if (t > b) { // Empty.
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = a->get(b);
+        if (t == b) { // Last item: race the thieves for it.
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+    
+    // Any thread. Takes the oldest item. Returns false if the deque is empty or another thread got there first.
+    bool steal(T &item) {
+        long long t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        Buffer *a = buffer.load(std::memory_order_acquire);
+        T stolen = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        item = stolen;
+        return true;
+    }
+    
+    // Only a hint when other threads are active.
+    bool is_empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+    
+private:
+    struct Buffer {
+        long long capacity;
+        long long mask;
+        std::unique_ptr<std::atomic<T>[]> items;
+        Buffer(long long capacity) : capacity(capacity), mask(capacity - 1), items(new std::atomic<T>[capacity]) {}
+        T get(long long i) const {return items[i & mask].load(std::memory_order_relaxed);}
+        void put(long long i, T item) {items[i & mask].store(item, std::memory_order_relaxed);}
+    };
+    
+    Buffer *grow(Buffer *old, long long b, long long t) {
+        Buffer *bigger = new Buffer(old->capacity * 2);
+        for (long long i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        buffers.emplace_back(bigger);
+        buffer.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+    
+    std::atomic<long long> top;
+    char padding[64]; // Thieves hammer top, the owner hammers bottom.
+    std::atomic<long long> bottom;
+    std::atomic<Buffer *> buffer;
+    std::vector<std::unique_ptr<Buffer> > buffers; // Owner only. The live buffer and every retired one.
+};
+
+} // NS : vvalgo
+
+#endif // APFN_DATA_STRUCTURES_WORK_STEALING_DEQUE_H
@@ -39,7 +39,7 @@ void swap(T a, T b) {
  */
 template <typename T>
 T selectKthSmallest(T begin, T end, unsigned long long k) {
-	if (k > (end - begin)) { // if we do not have k elements to begin with, return failure.
+	if (k > static_cast<unsigned long long>(end - begin)) { // if we do not have k elements to begin with, return failure.
 		return end; 	// The 'end' iterator indicates that we could not find the kth smallest number. 
 	}
 